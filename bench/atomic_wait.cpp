@@ -0,0 +1,110 @@
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "blet/atomic_wait.h"
+#include "blet/thread.h"
+
+// two threads handing a turn back and forth, each handoff blocks the sender
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+struct CondTurn {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int turn;
+};
+
+static void condPlayer(CondTurn* pTurn, int player, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        ::pthread_mutex_lock(&pTurn->mutex);
+        while (pTurn->turn != player) {
+            ::pthread_cond_wait(&pTurn->cond, &pTurn->mutex);
+        }
+        pTurn->turn = 1 - player;
+        ::pthread_cond_signal(&pTurn->cond);
+        ::pthread_mutex_unlock(&pTurn->mutex);
+    }
+}
+
+static double benchCond(int rounds) {
+    CondTurn turn;
+    ::pthread_mutex_init(&turn.mutex, NULL);
+    ::pthread_cond_init(&turn.cond, NULL);
+    turn.turn = 0;
+    double start = now();
+    blet::Thread ping(&condPlayer, &turn, 0, rounds);
+    blet::Thread pong(&condPlayer, &turn, 1, rounds);
+    ping.join();
+    pong.join();
+    double seconds = now() - start;
+    ::pthread_cond_destroy(&turn.cond);
+    ::pthread_mutex_destroy(&turn.mutex);
+    return seconds;
+}
+
+static void waitPlayer(int* pTurn, int player, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        int turn = __atomic_load_n(pTurn, __ATOMIC_ACQUIRE);
+        while (turn != player) {
+            blet::atomic_wait(pTurn, turn);
+            turn = __atomic_load_n(pTurn, __ATOMIC_ACQUIRE);
+        }
+        __atomic_store_n(pTurn, 1 - player, __ATOMIC_RELEASE);
+        blet::atomic_notify_one(pTurn);
+    }
+}
+
+static double benchAtomicWait(int rounds) {
+    int turn = 0;
+    double start = now();
+    blet::Thread ping(&waitPlayer, &turn, 0, rounds);
+    blet::Thread pong(&waitPlayer, &turn, 1, rounds);
+    ping.join();
+    pong.join();
+    return now() - start;
+}
+
+static void parkPlayer(blet::Thread* pOther, bool isFirst, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        if (isFirst) {
+            blet::unpark(*pOther);
+            blet::park();
+        }
+        else {
+            blet::park();
+            blet::unpark(*pOther);
+        }
+    }
+}
+
+static double benchPark(int rounds) {
+    blet::Thread ping;
+    blet::Thread pong;
+    double start = now();
+    ping.start(&parkPlayer, &pong, true, rounds);
+    pong.start(&parkPlayer, &ping, false, rounds);
+    ping.join();
+    pong.join();
+    return now() - start;
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::printf("%d round trips\n", rounds);
+    std::printf("%-16s %12s\n", "handoff", "ns/roundtrip");
+    std::printf("%-16s %12.0f\n", "mutex+condvar",
+                benchCond(rounds) * 1000000000.0 / rounds);
+    std::printf("%-16s %12.0f\n", "atomic_wait",
+                benchAtomicWait(rounds) * 1000000000.0 / rounds);
+    std::printf("%-16s %12.0f\n", "park/unpark",
+                benchPark(rounds) * 1000000000.0 / rounds);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/barrier.h"
+#include "blet/thread.h"
+
+// phase transitions of workers running empty phases
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void barrierPhases(blet::Barrier* pBarrier, int phases) {
+    for (int i = 0; i < phases; ++i) {
+        pBarrier->arrive_and_wait();
+    }
+}
+
+static void pthreadPhases(pthread_barrier_t* pBarrier, int phases) {
+    for (int i = 0; i < phases; ++i) {
+        ::pthread_barrier_wait(pBarrier);
+    }
+}
+
+static void nothing() {}
+
+// ns per phase
+static double benchBarrier(std::size_t workers, int phases,
+                           unsigned int spinCount) {
+    blet::Barrier barrier(static_cast<unsigned int>(workers), spinCount);
+    std::vector<blet::Thread> threads(workers);
+    double start = now();
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].start(&barrierPhases, &barrier, phases);
+    }
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].join();
+    }
+    return (now() - start) * 1000000000.0 / phases;
+}
+
+static double benchPthread(std::size_t workers, int phases) {
+    pthread_barrier_t barrier;
+    ::pthread_barrier_init(&barrier, NULL, static_cast<unsigned int>(workers));
+    std::vector<blet::Thread> threads(workers);
+    double start = now();
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].start(&pthreadPhases, &barrier, phases);
+    }
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].join();
+    }
+    double ns = (now() - start) * 1000000000.0 / phases;
+    ::pthread_barrier_destroy(&barrier);
+    return ns;
+}
+
+// start and join persistent workers for every phase
+static double benchRestart(std::size_t workers, int phases) {
+    std::vector<blet::Thread> threads(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].set_persistent(true);
+    }
+    double start = now();
+    for (int phase = 0; phase < phases; ++phase) {
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads[i].start(&nothing);
+        }
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads[i].join();
+        }
+    }
+    return (now() - start) * 1000000000.0 / phases;
+}
+
+int main(int argc, char* argv[]) {
+    int phases = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::size_t maxWorkers =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 8;
+    std::printf("%d phases, ns per phase\n", phases);
+    std::printf("%8s %12s %12s %12s %12s\n", "workers", "restart",
+                "pthread", "park", "spin+park");
+    for (std::size_t workers = 2; workers <= maxWorkers; workers *= 2) {
+        std::printf("%8lu %12.0f %12.0f %12.0f %12.0f\n",
+                    static_cast<unsigned long>(workers),
+                    benchRestart(workers, phases),
+                    benchPthread(workers, phases),
+                    benchBarrier(workers, phases, 0),
+                    benchBarrier(workers, phases, BLET_BARRIER_SPIN));
+    }
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+
+#include "blet/thread.h"
+#include "blet/thread_pool.h"
+
+// spawn path of Thread::start, one JSON document on stdout:
+// - latency: start call to the first instruction of the thread
+// - roundtrip: start then join
+// - arity: start then join through the 0 to 10 argument overloads
+// - memory: resident and virtual memory per parked thread
+
+static long nowNs() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static bool isFirst = true;
+
+static void report(const char* name, std::vector<long> samples) {
+    std::sort(samples.begin(), samples.end());
+    std::size_t size = samples.size();
+    double sum = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += samples[i];
+    }
+    std::printf("%s\n    {\"name\": \"%s\", \"unit\": \"ns\", \"samples\": %lu, "
+                "\"mean\": %.1f, \"p50\": %ld, \"p99\": %ld, \"p999\": %ld, "
+                "\"max\": %ld}",
+                isFirst ? "" : ",", name, static_cast<unsigned long>(size),
+                sum / size, samples[size / 2], samples[size * 99 / 100],
+                samples[size * 999 / 1000], samples[size - 1]);
+    isFirst = false;
+}
+
+static void firstInstruction(long* pStart) {
+    *pStart = nowNs();
+}
+
+static void* pthreadFirstInstruction(void* data) {
+    *static_cast<long*>(data) = nowNs();
+    return NULL;
+}
+
+static void benchLatency(std::size_t count) {
+    std::vector<long> samples(count);
+    long start = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        blet::Thread thrd;
+        long before = nowNs();
+        thrd.start(&firstInstruction, &start);
+        thrd.join();
+        samples[i] = start - before;
+    }
+    report("latency/thread", samples);
+
+    blet::Thread persistent;
+    persistent.set_persistent(true);
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        persistent.start(&firstInstruction, &start);
+        persistent.join();
+        samples[i] = start - before;
+    }
+    report("latency/thread_persistent", samples);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        pthread_t id;
+        long before = nowNs();
+        ::pthread_create(&id, NULL, &pthreadFirstInstruction, &start);
+        ::pthread_join(id, NULL);
+        samples[i] = start - before;
+    }
+    report("latency/pthread_create", samples);
+
+#if __cplusplus >= 201103L
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        std::thread thrd(&firstInstruction, &start);
+        thrd.join();
+        samples[i] = start - before;
+    }
+    report("latency/std_thread", samples);
+#endif
+
+    blet::ThreadPool pool(1);
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        pool.submit(&firstInstruction, &start);
+        pool.wait();
+        samples[i] = start - before;
+    }
+    report("latency/thread_pool", samples);
+}
+
+static void nothing() {}
+
+static void* pthreadNothing(void*) {
+    return NULL;
+}
+
+static void benchRoundtrip(std::size_t count) {
+    std::vector<long> samples(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        blet::Thread thrd(&nothing);
+        thrd.join();
+        samples[i] = nowNs() - before;
+    }
+    report("roundtrip/thread", samples);
+
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_cache(true);
+    blet::Thread cached(attributes);
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        cached.start(&nothing);
+        cached.join();
+        samples[i] = nowNs() - before;
+    }
+    report("roundtrip/thread_stack_cache", samples);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        pthread_t id;
+        long before = nowNs();
+        ::pthread_create(&id, NULL, &pthreadNothing, NULL);
+        ::pthread_join(id, NULL);
+        samples[i] = nowNs() - before;
+    }
+    report("roundtrip/pthread_create", samples);
+
+#if __cplusplus >= 201103L
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        std::thread thrd(&nothing);
+        thrd.join();
+        samples[i] = nowNs() - before;
+    }
+    report("roundtrip/std_thread", samples);
+#endif
+}
+
+static void args0() {}
+static void args1(int) {}
+static void args2(int, int) {}
+static void args3(int, int, int) {}
+static void args4(int, int, int, int) {}
+static void args5(int, int, int, int, int) {}
+static void args6(int, int, int, int, int, int) {}
+static void args7(int, int, int, int, int, int, int) {}
+static void args8(int, int, int, int, int, int, int, int) {}
+static void args9(int, int, int, int, int, int, int, int, int) {}
+static void args10(int, int, int, int, int, int, int, int, int, int) {}
+
+// larger than BLET_THREAD_INLINE_SIZE, copied to the ThreadDataPool
+struct Large {
+    char data[BLET_THREAD_INLINE_SIZE * 2];
+};
+
+static void argsLarge(Large) {}
+
+static void benchArity(std::size_t count) {
+    std::vector<long> samples(count);
+    blet::Thread thrd;
+    char name[32];
+    for (int arity = 0; arity <= 10; ++arity) {
+        for (std::size_t i = 0; i < count; ++i) {
+            long before = nowNs();
+            switch (arity) {
+                case 0:
+                    thrd.start(&args0);
+                    break;
+                case 1:
+                    thrd.start(&args1, 1);
+                    break;
+                case 2:
+                    thrd.start(&args2, 1, 2);
+                    break;
+                case 3:
+                    thrd.start(&args3, 1, 2, 3);
+                    break;
+                case 4:
+                    thrd.start(&args4, 1, 2, 3, 4);
+                    break;
+                case 5:
+                    thrd.start(&args5, 1, 2, 3, 4, 5);
+                    break;
+                case 6:
+                    thrd.start(&args6, 1, 2, 3, 4, 5, 6);
+                    break;
+                case 7:
+                    thrd.start(&args7, 1, 2, 3, 4, 5, 6, 7);
+                    break;
+                case 8:
+                    thrd.start(&args8, 1, 2, 3, 4, 5, 6, 7, 8);
+                    break;
+                case 9:
+                    thrd.start(&args9, 1, 2, 3, 4, 5, 6, 7, 8, 9);
+                    break;
+                default:
+                    thrd.start(&args10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+                    break;
+            }
+            thrd.join();
+            samples[i] = nowNs() - before;
+        }
+        std::sprintf(name, "arity/%d", arity);
+        report(name, samples);
+    }
+
+    Large large;
+    std::memset(large.data, 0, sizeof(large.data));
+    for (std::size_t i = 0; i < count; ++i) {
+        long before = nowNs();
+        thrd.start(&argsLarge, large);
+        thrd.join();
+        samples[i] = nowNs() - before;
+    }
+    report("arity/heap", samples);
+}
+
+// kB of VmRSS and VmSize
+static void readMemory(long* pRss, long* pSize) {
+    *pRss = 0;
+    *pSize = 0;
+    std::FILE* pFile = std::fopen("/proc/self/status", "r");
+    if (pFile == NULL) {
+        return;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), pFile) != NULL) {
+        std::sscanf(line, "VmRSS: %ld", pRss);
+        std::sscanf(line, "VmSize: %ld", pSize);
+    }
+    std::fclose(pFile);
+}
+
+static void park(int* pFlag) {
+    while (__atomic_load_n(pFlag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+static void benchMemory(std::size_t count) {
+    int flag = 0;
+    long rssBefore;
+    long sizeBefore;
+    readMemory(&rssBefore, &sizeBefore);
+    std::vector<blet::Thread> threads(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads[i].start(&park, &flag);
+    }
+    long rssAfter;
+    long sizeAfter;
+    readMemory(&rssAfter, &sizeAfter);
+    __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads[i].join();
+    }
+    std::printf("%s\n    {\"name\": \"memory/thread\", \"unit\": \"bytes\", "
+                "\"threads\": %lu, \"rss_per_thread\": %ld, "
+                "\"virtual_per_thread\": %ld}",
+                isFirst ? "" : ",", static_cast<unsigned long>(count),
+                (rssAfter - rssBefore) * 1024 / static_cast<long>(count),
+                (sizeAfter - sizeBefore) * 1024 / static_cast<long>(count));
+    isFirst = false;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t count =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 10000;
+    std::size_t threads =
+        argc > 2 ? static_cast<std::size_t>(std::atol(argv[2])) : 100;
+    std::printf("{\n  \"inline_size\": %d,\n  \"benchmarks\": [",
+                BLET_THREAD_INLINE_SIZE);
+    benchLatency(count);
+    benchRoundtrip(count);
+    benchArity(count);
+    benchMemory(threads);
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+
+#include "blet/mpmc_queue.h"
+#include "blet/thread.h"
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void report(const char* name, int producers, int consumers, int items,
+                   double seconds) {
+    std::printf("%-16s %2dP/%2dC %10d items %10.3f ms %12.0f items/s\n", name,
+                producers, consumers, items, seconds * 1000.0,
+                items / seconds);
+}
+
+// the baseline: std::deque behind a mutex, bounded with two conditions
+class LockedQueue {
+  public:
+    explicit LockedQueue(std::size_t capacity) :
+        capacity_(capacity) {
+        ::pthread_mutex_init(&mutex_, NULL);
+        ::pthread_cond_init(&notEmpty_, NULL);
+        ::pthread_cond_init(&notFull_, NULL);
+    }
+    ~LockedQueue() {
+        ::pthread_cond_destroy(&notFull_);
+        ::pthread_cond_destroy(&notEmpty_);
+        ::pthread_mutex_destroy(&mutex_);
+    }
+    void push(const int& value) {
+        ::pthread_mutex_lock(&mutex_);
+        while (values_.size() >= capacity_) {
+            ::pthread_cond_wait(&notFull_, &mutex_);
+        }
+        values_.push_back(value);
+        ::pthread_mutex_unlock(&mutex_);
+        ::pthread_cond_signal(&notEmpty_);
+    }
+    void pop(int& value) {
+        ::pthread_mutex_lock(&mutex_);
+        while (values_.empty()) {
+            ::pthread_cond_wait(&notEmpty_, &mutex_);
+        }
+        value = values_.front();
+        values_.pop_front();
+        ::pthread_mutex_unlock(&mutex_);
+        ::pthread_cond_signal(&notFull_);
+    }
+
+  private:
+    std::size_t capacity_;
+    std::deque<int> values_;
+    ::pthread_mutex_t mutex_;
+    ::pthread_cond_t notEmpty_;
+    ::pthread_cond_t notFull_;
+};
+
+template<typename Queue>
+static void produce(Queue* pQueue, int count) {
+    for (int i = 0; i < count; ++i) {
+        pQueue->push(i);
+    }
+}
+
+template<typename Queue>
+static void consume(Queue* pQueue, int count) {
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        pQueue->pop(value);
+    }
+}
+
+template<typename Queue>
+static void bench(const char* name, int producers, int consumers,
+                  int items) {
+    Queue queue(1024);
+    blet::Thread* threads = new blet::Thread[producers + consumers];
+    double start = now();
+    for (int i = 0; i < consumers; ++i) {
+        threads[i].start(&consume<Queue>, &queue, items / consumers);
+    }
+    for (int i = 0; i < producers; ++i) {
+        threads[consumers + i].start(&produce<Queue>, &queue,
+                                     items / producers);
+    }
+    delete[] threads;
+    report(name, producers, consumers, items, now() - start);
+}
+
+int main(int argc, char* argv[]) {
+    int items = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 4;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        // divisible by both sides
+        int count = items - items % threads;
+        bench<LockedQueue>("mutex-deque", threads, threads, count);
+        bench<blet::MpmcQueue<int> >("mpmc-queue", threads, threads, count);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/mcs_lock.h"
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+// same lock and unlock interface as blet::Mutex
+class PthreadMutex {
+  public:
+    PthreadMutex() {
+        ::pthread_mutex_init(&mutex_, NULL);
+    }
+    ~PthreadMutex() {
+        ::pthread_mutex_destroy(&mutex_);
+    }
+    void lock() {
+        ::pthread_mutex_lock(&mutex_);
+    }
+    void unlock() {
+        ::pthread_mutex_unlock(&mutex_);
+    }
+
+  private:
+    ::pthread_mutex_t mutex_;
+};
+
+template<typename M>
+struct Shared {
+    M mutex;
+    long counter;
+};
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+// short critical section, like a counter update
+template<typename M>
+static void hammer(Shared<M>* pShared, int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        blet::LockGuard<M> guard(pShared->mutex);
+        ++pShared->counter;
+    }
+}
+
+template<typename M>
+static double bench(std::size_t threadCount, int iterations) {
+    Shared<M> shared;
+    shared.counter = 0;
+    std::vector<blet::Thread> threads(threadCount);
+    double start = now();
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads[i].start(&hammer<M>, &shared, iterations);
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads[i].join();
+    }
+    double seconds = now() - start;
+    if (shared.counter != static_cast<long>(threadCount) * iterations) {
+        std::printf("lost update\n");
+        std::exit(1);
+    }
+    // ns per acquire
+    return seconds * 1000000000.0 / (static_cast<double>(threadCount) *
+                                    iterations);
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::size_t maxThreads =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 64;
+    std::printf("%d acquires per thread\n", iterations);
+    std::printf("%8s %16s %16s %16s\n", "threads", "pthread ns/op",
+                "mutex ns/op", "mcs ns/op");
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double pthread = bench<PthreadMutex>(threads, iterations);
+        double mutex = bench<blet::Mutex>(threads, iterations);
+        double mcs = bench<blet::McsLock>(threads, iterations);
+        std::printf("%8lu %16.1f %16.1f %16.1f\n",
+                    static_cast<unsigned long>(threads), pthread, mutex, mcs);
+    }
+    return 0;
+}
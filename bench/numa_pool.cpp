@@ -0,0 +1,123 @@
+#include <sched.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/numa_pool.h"
+#include "blet/thread.h"
+#include "blet/thread_pool.h"
+
+// memory-bound call: sum a buffer living on one node
+struct Job {
+    const long* values;
+    std::size_t count;
+    const cpu_set_t* pNodeCpus;
+    long sum;
+};
+
+static unsigned long localRuns = 0;
+static unsigned long remoteRuns = 0;
+
+static void sumJob(Job* pJob) {
+    long sum = 0;
+    for (std::size_t i = 0; i < pJob->count; ++i) {
+        sum += pJob->values[i];
+    }
+    pJob->sum = sum;
+    int cpu = ::sched_getcpu();
+    if (cpu >= 0 && CPU_ISSET(cpu, pJob->pNodeCpus)) {
+        __atomic_fetch_add(&localRuns, 1, __ATOMIC_RELAXED);
+    }
+    else {
+        __atomic_fetch_add(&remoteRuns, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void report(const char* name, std::size_t jobs, double seconds) {
+    unsigned long local = __atomic_exchange_n(&localRuns, 0, __ATOMIC_RELAXED);
+    unsigned long remote =
+        __atomic_exchange_n(&remoteRuns, 0, __ATOMIC_RELAXED);
+    std::printf("%-12s %8lu jobs %10.3f ms %8lu local %8lu remote\n", name,
+                static_cast<unsigned long>(jobs), seconds * 1000.0, local,
+                remote);
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t buffersPerNode =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 64;
+    std::size_t bufferSize =
+        argc > 2 ? static_cast<std::size_t>(std::atol(argv[2])) : 4194304;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 4;
+    std::size_t count = bufferSize / sizeof(long);
+
+    blet::NumaPool numaPool;
+    blet::ThreadPool threadPool(numaPool.size());
+    std::printf("%lu nodes, %lu workers, %lu buffers of %lu bytes per node\n",
+                static_cast<unsigned long>(numaPool.node_count()),
+                static_cast<unsigned long>(numaPool.size()),
+                static_cast<unsigned long>(buffersPerNode),
+                static_cast<unsigned long>(bufferSize));
+
+    // every buffer placed on the memory of its node
+    std::vector<Job> jobs;
+    std::vector<std::size_t> jobNodes;
+    for (std::size_t node = 0; node < numaPool.node_count(); ++node) {
+        for (std::size_t i = 0; i < buffersPerNode; ++i) {
+            long* values = static_cast<long*>(blet::NumaPool::allocate_on_node(
+                bufferSize, numaPool.node_id(node)));
+            if (values == NULL) {
+                std::perror("allocate_on_node");
+                return 1;
+            }
+            for (std::size_t j = 0; j < count; ++j) {
+                values[j] = static_cast<long>(j);
+            }
+            Job job = {values, count, &numaPool.node_cpus(node), 0};
+            jobs.push_back(job);
+            jobNodes.push_back(node);
+        }
+    }
+
+    // any worker may run any buffer
+    double start = now();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            threadPool.submit(&sumJob, &jobs[i]);
+        }
+        threadPool.wait();
+    }
+    report("thread-pool", jobs.size() * rounds, now() - start);
+
+    // each buffer queued on its node
+    start = now();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            numaPool.node(jobNodes[i]).submit(&sumJob, &jobs[i]);
+        }
+        numaPool.wait();
+    }
+    report("numa-pool", jobs.size() * rounds, now() - start);
+    blet::NumaPool::Stats stats = numaPool.stats();
+    std::printf("numa-pool stats: %lu local tasks, %lu stolen tasks\n",
+                stats.localTasks, stats.remoteTasks);
+
+    long expected = static_cast<long>(count) * (static_cast<long>(count) - 1) /
+                    2;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (jobs[i].sum != expected) {
+            return 1;
+        }
+        blet::NumaPool::deallocate_on_node(const_cast<long*>(jobs[i].values),
+                                           bufferSize);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <sched.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/thread.h"
+
+// cyclictest-like loop: sleep until an absolute deadline and record how late
+// the thread wakes up
+struct Cycle {
+    long intervalNs;
+    std::vector<long> latencies;
+};
+
+static long diffNs(const struct timespec& after,
+                   const struct timespec& before) {
+    return (after.tv_sec - before.tv_sec) * 1000000000L +
+           (after.tv_nsec - before.tv_nsec);
+}
+
+static void runCycles(Cycle* pCycle) {
+    struct timespec next;
+    ::clock_gettime(CLOCK_MONOTONIC, &next);
+    for (std::size_t i = 0; i < pCycle->latencies.size(); ++i) {
+        next.tv_nsec += pCycle->intervalNs;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            ++next.tv_sec;
+        }
+        ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        pCycle->latencies[i] = diffNs(now, next);
+    }
+}
+
+static void report(const char* name, std::vector<long> latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    std::size_t size = latencies.size();
+    double sum = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += latencies[i];
+    }
+    std::printf("%-12s min %7.1f us avg %7.1f us p50 %7.1f us p99 %7.1f us "
+                "p99.9 %7.1f us max %7.1f us\n",
+                name, latencies[0] / 1000.0, sum / size / 1000.0,
+                latencies[size / 2] / 1000.0,
+                latencies[size * 99 / 100] / 1000.0,
+                latencies[size * 999 / 1000] / 1000.0,
+                latencies[size - 1] / 1000.0);
+}
+
+static void bench(const char* name, const blet::Thread::Attributes& attributes,
+                  std::size_t loops, long intervalUs) {
+    Cycle cycle;
+    cycle.intervalNs = intervalUs * 1000;
+    cycle.latencies.resize(loops);
+    blet::Thread thrd(attributes);
+    try {
+        thrd.start(&runCycles, &cycle);
+    }
+    catch (const blet::Thread::Exception& e) {
+        std::printf("%-12s %s\n", name, e.what());
+        return;
+    }
+    thrd.join();
+    report(name, cycle.latencies);
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t loops =
+        argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 10000;
+    long intervalUs = argc > 2 ? std::atol(argv[2]) : 1000;
+    int priority = argc > 3 ? std::atoi(argv[3]) : 80;
+    std::printf("%lu loops, %ld us interval\n",
+                static_cast<unsigned long>(loops), intervalUs);
+
+    blet::Thread::Attributes normal;
+    bench("SCHED_OTHER", normal, loops, intervalUs);
+
+    // fails without CAP_SYS_NICE and CAP_IPC_LOCK
+    blet::Thread::Attributes fifo;
+    fifo.set_realtime(SCHED_FIFO, priority);
+    bench("SCHED_FIFO", fifo, loops, intervalUs);
+
+    blet::Thread::Attributes rr;
+    rr.set_realtime(SCHED_RR, priority);
+    bench("SCHED_RR", rr, loops, intervalUs);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/rw_lock.h"
+#include "blet/thread.h"
+
+// same shared lock interface as blet::RwLock
+class PthreadRwLock {
+  public:
+    PthreadRwLock() {
+        ::pthread_rwlock_init(&rwlock_, NULL);
+    }
+    ~PthreadRwLock() {
+        ::pthread_rwlock_destroy(&rwlock_);
+    }
+    void lock_shared() {
+        ::pthread_rwlock_rdlock(&rwlock_);
+    }
+    void unlock_shared() {
+        ::pthread_rwlock_unlock(&rwlock_);
+    }
+
+  private:
+    ::pthread_rwlock_t rwlock_;
+};
+
+// routing table read by every reader
+template<typename L>
+struct Table {
+    L lock;
+    long routes[16];
+};
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+template<typename L>
+static void readTable(Table<L>* pTable, int reads, long* pSum) {
+    long sum = 0;
+    for (int i = 0; i < reads; ++i) {
+        blet::SharedLockGuard<L> guard(pTable->lock);
+        sum += pTable->routes[i & 15];
+    }
+    *pSum = sum;
+}
+
+// million reads per second over all the readers
+template<typename L>
+static double bench(std::size_t readers, int reads) {
+    Table<L> table;
+    for (int i = 0; i < 16; ++i) {
+        table.routes[i] = i;
+    }
+    std::vector<long> sums(readers);
+    std::vector<blet::Thread> threads(readers);
+    double start = now();
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads[i].start(&readTable<L>, &table, reads, &sums[i]);
+    }
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads[i].join();
+    }
+    return static_cast<double>(readers) * reads / (now() - start) / 1000000.0;
+}
+
+int main(int argc, char* argv[]) {
+    int reads = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::size_t maxReaders =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 64;
+    std::printf("%d reads per reader, %lu slots\n", reads,
+                static_cast<unsigned long>(blet::RwLock().slot_count()));
+    std::printf("%8s %20s %20s\n", "readers", "pthread Mreads/s",
+                "rw-lock Mreads/s");
+    for (std::size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        double pthread = bench<PthreadRwLock>(readers, reads);
+        double rwLock = bench<blet::RwLock>(readers, reads);
+        std::printf("%8lu %20.1f %20.1f\n",
+                    static_cast<unsigned long>(readers), pthread, rwLock);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/mutex.h"
+#include "blet/seq_lock.h"
+#include "blet/thread.h"
+
+// prices snapshot of 128 bytes
+struct Snapshot {
+    long values[128 / sizeof(long)];
+};
+
+// same load and store interface as blet::SeqLock
+class MutexSnapshot {
+  public:
+    MutexSnapshot() :
+        value_() {}
+    Snapshot load() {
+        blet::LockGuard<blet::Mutex> guard(mutex_);
+        return value_;
+    }
+    void store(const Snapshot& value) {
+        blet::LockGuard<blet::Mutex> guard(mutex_);
+        value_ = value;
+    }
+
+  private:
+    blet::Mutex mutex_;
+    Snapshot value_;
+};
+
+template<typename S>
+struct Shared {
+    S snapshot;
+    int stop;
+};
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+template<typename S>
+static void reader(Shared<S>* pShared, int reads, long* pSum) {
+    long sum = 0;
+    for (int i = 0; i < reads; ++i) {
+        sum += pShared->snapshot.load().values[i & 15];
+    }
+    *pSum = sum;
+}
+
+// one writer updating until the readers are done
+template<typename S>
+static void writer(Shared<S>* pShared) {
+    Snapshot snapshot = Snapshot();
+    while (__atomic_load_n(&pShared->stop, __ATOMIC_ACQUIRE) == 0) {
+        ++snapshot.values[0];
+        pShared->snapshot.store(snapshot);
+        for (int i = 0; i < 1000; ++i) {
+            blet::cpu_relax();
+        }
+    }
+}
+
+// million loads per second over all the readers
+template<typename S>
+static double bench(std::size_t readers, int reads) {
+    Shared<S> shared;
+    shared.stop = 0;
+    std::vector<long> sums(readers);
+    std::vector<blet::Thread> threads(readers);
+    blet::Thread writerThread(&writer<S>, &shared);
+    double start = now();
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads[i].start(&reader<S>, &shared, reads, &sums[i]);
+    }
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads[i].join();
+    }
+    double seconds = now() - start;
+    __atomic_store_n(&shared.stop, 1, __ATOMIC_RELEASE);
+    writerThread.join();
+    return static_cast<double>(readers) * reads / seconds / 1000000.0;
+}
+
+int main(int argc, char* argv[]) {
+    int reads = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::size_t maxReaders =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 16;
+    std::printf("%d loads of %lu bytes per reader, one writer\n", reads,
+                static_cast<unsigned long>(sizeof(Snapshot)));
+    std::printf("%8s %18s %18s\n", "readers", "mutex Mloads/s",
+                "seq-lock Mloads/s");
+    for (std::size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        double mutex = bench<MutexSnapshot>(readers, reads);
+        double seqLock = bench<blet::SeqLock<Snapshot> >(readers, reads);
+        std::printf("%8lu %18.1f %18.1f\n",
+                    static_cast<unsigned long>(readers), mutex, seqLock);
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "blet/mpmc_queue.h"
+#include "blet/spsc_queue.h"
+#include "blet/thread.h"
+#include "blet/topology.h"
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void report(const char* name, long messages, double seconds) {
+    std::printf("%-16s %10ld msgs %10.3f ms %14.0f msgs/s\n", name, messages,
+                seconds * 1000.0, messages / seconds);
+}
+
+// consumer and producer cpus, chosen in main
+static int cpus[2] = {0, 0};
+
+static void pin(int side) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[side], &set);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+}
+
+// the closest cpu to the consumer: sharing its L2, then its L3, then any
+static void placePair() {
+    blet::Topology topology;
+    if (topology.cpus().empty()) {
+        return;
+    }
+    cpus[0] = topology.cpus()[0].id;
+    cpus[1] = topology.sharing_cpu(cpus[0], 2);
+    if (cpus[1] == -1) {
+        cpus[1] = topology.sharing_cpu(cpus[0], 3);
+    }
+    if (cpus[1] == -1) {
+        cpus[1] = topology.cpus().back().id;
+    }
+}
+
+static void produceOne(blet::SpscQueue<long>* pQueue, long messages) {
+    pin(1);
+    for (long i = 0; i < messages; ++i) {
+        while (!pQueue->try_push(i)) {
+            ::sched_yield();
+        }
+    }
+}
+
+static void produceBatch(blet::SpscQueue<long>* pQueue, long messages,
+                         long batch) {
+    pin(1);
+    long values[256];
+    for (long i = 0; i < messages;) {
+        long size = batch < messages - i ? batch : messages - i;
+        for (long j = 0; j < size; ++j) {
+            values[j] = i + j;
+        }
+        long pushed = 0;
+        while (pushed < size) {
+            std::size_t count = pQueue->push_n(
+                values + pushed, static_cast<std::size_t>(size - pushed));
+            if (count == 0) {
+                ::sched_yield();
+            }
+            pushed += static_cast<long>(count);
+        }
+        i += size;
+    }
+}
+
+static void produceMpmc(blet::MpmcQueue<long>* pQueue, long messages) {
+    pin(1);
+    for (long i = 0; i < messages; ++i) {
+        while (!pQueue->try_push(i)) {
+            ::sched_yield();
+        }
+    }
+}
+
+static void benchOne(long messages) {
+    blet::SpscQueue<long> queue(4096);
+    pin(0);
+    double start = now();
+    blet::Thread producer(&produceOne, &queue, messages);
+    long value = 0;
+    for (long i = 0; i < messages; ++i) {
+        while (!queue.try_pop(value)) {
+            ::sched_yield();
+        }
+    }
+    producer.join();
+    report("spsc", messages, now() - start);
+}
+
+static void benchBatch(long messages, long batch) {
+    blet::SpscQueue<long> queue(4096);
+    pin(0);
+    double start = now();
+    blet::Thread producer(&produceBatch, &queue, messages, batch);
+    long values[256];
+    for (long i = 0; i < messages;) {
+        std::size_t count =
+            queue.pop_n(values, static_cast<std::size_t>(batch));
+        if (count == 0) {
+            ::sched_yield();
+        }
+        i += static_cast<long>(count);
+    }
+    producer.join();
+    char name[32];
+    std::sprintf(name, "spsc-batch-%ld", batch);
+    report(name, messages, now() - start);
+}
+
+static void benchMpmc(long messages) {
+    blet::MpmcQueue<long> queue(4096);
+    pin(0);
+    double start = now();
+    blet::Thread producer(&produceMpmc, &queue, messages);
+    long value = 0;
+    for (long i = 0; i < messages; ++i) {
+        while (!queue.try_pop(value)) {
+            ::sched_yield();
+        }
+    }
+    producer.join();
+    report("mpmc", messages, now() - start);
+}
+
+int main(int argc, char* argv[]) {
+    long messages = argc > 1 ? std::atol(argv[1]) : 100000000;
+    placePair();
+    std::printf("consumer on cpu %d, producer on cpu %d\n", cpus[0], cpus[1]);
+    benchMpmc(messages);
+    benchOne(messages);
+    benchBatch(messages, 16);
+    benchBatch(messages, 256);
+    return 0;
+}
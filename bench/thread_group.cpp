@@ -0,0 +1,81 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/thread.h"
+#include "blet/thread_group.h"
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+// scatter-gather leaf: record when the work starts
+static void leaf(double* pStart) {
+    *pStart = now();
+}
+
+static void report(const char* name, int rounds, double seconds,
+                   double skew) {
+    std::printf("%-14s %10.1f us/round %10.1f us start skew\n", name,
+                seconds * 1000000.0 / rounds, skew * 1000000.0 / rounds);
+}
+
+static double spread(const std::vector<double>& starts) {
+    double first = starts[0];
+    double last = starts[0];
+    for (std::size_t i = 1; i < starts.size(); ++i) {
+        first = starts[i] < first ? starts[i] : first;
+        last = starts[i] > last ? starts[i] : last;
+    }
+    return last - first;
+}
+
+// one start and one join per thread
+static void benchThreads(int rounds, std::size_t threads) {
+    std::vector<double> starts(threads);
+    double skew = 0;
+    double begin = now();
+    for (int round = 0; round < rounds; ++round) {
+        std::vector<blet::Thread> group(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            group[i].start(&leaf, &starts[i]);
+        }
+        for (std::size_t i = 0; i < threads; ++i) {
+            group[i].join();
+        }
+        skew += spread(starts);
+    }
+    report("thread", rounds, now() - begin, skew);
+}
+
+// start barrier and single countdown
+static void benchThreadGroup(int rounds, std::size_t threads) {
+    std::vector<double> starts(threads);
+    double skew = 0;
+    blet::ThreadGroup group;
+    double begin = now();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            group.submit(&leaf, &starts[i]);
+        }
+        group.join();
+        skew += spread(starts);
+    }
+    report("thread-group", rounds, now() - begin, skew);
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 1000;
+    std::size_t threads =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 64;
+    std::printf("%d rounds of %lu threads\n", rounds,
+                static_cast<unsigned long>(threads));
+    benchThreads(rounds, threads);
+    benchThreadGroup(rounds, threads);
+    return 0;
+}
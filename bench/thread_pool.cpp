@@ -0,0 +1,89 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blet/thread.h"
+#include "blet/thread_pool.h"
+
+static int counter = 0;
+
+static void task(int value) {
+    __atomic_fetch_add(&counter, value, __ATOMIC_RELAXED);
+}
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void report(const char* name, int tasks, double seconds) {
+    std::printf("%-24s %8d tasks %10.3f ms %12.0f tasks/s\n", name, tasks,
+                seconds * 1000.0, tasks / seconds);
+}
+
+// one new thread per task, at most `workers` running at the same time
+static void benchSpawnPerTask(int tasks, std::size_t workers) {
+    std::vector<blet::Thread> threads(workers);
+    double start = now();
+    for (int i = 0; i < tasks; ++i) {
+        blet::Thread& thrd = threads[i % workers];
+        if (thrd.joinable()) {
+            thrd.join();
+        }
+        thrd.start(&task, 1);
+    }
+    for (std::size_t i = 0; i < workers; ++i) {
+        if (threads[i].joinable()) {
+            threads[i].join();
+        }
+    }
+    report("spawn-per-task", tasks, now() - start);
+}
+
+// same pattern with the thread kept alive between the calls
+static void benchPersistent(int tasks, std::size_t workers) {
+    std::vector<blet::Thread> threads(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads[i].set_persistent(true);
+    }
+    double start = now();
+    for (int i = 0; i < tasks; ++i) {
+        blet::Thread& thrd = threads[i % workers];
+        if (thrd.joinable()) {
+            thrd.join();
+        }
+        thrd.start(&task, 1);
+    }
+    for (std::size_t i = 0; i < workers; ++i) {
+        if (threads[i].joinable()) {
+            threads[i].join();
+        }
+    }
+    report("persistent", tasks, now() - start);
+}
+
+static void benchThreadPool(int tasks, std::size_t workers) {
+    blet::ThreadPool pool(workers);
+    double start = now();
+    for (int i = 0; i < tasks; ++i) {
+        pool.submit(&task, 1);
+    }
+    pool.wait();
+    report("thread-pool", tasks, now() - start);
+}
+
+int main(int argc, char* argv[]) {
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::size_t workers =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 4;
+    std::printf("%d tasks on %lu workers\n", tasks,
+                static_cast<unsigned long>(workers));
+    benchSpawnPerTask(tasks, workers);
+    benchPersistent(tasks, workers);
+    benchThreadPool(tasks, workers);
+    return counter == 3 * tasks ? 0 : 1;
+}
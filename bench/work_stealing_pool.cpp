@@ -0,0 +1,64 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "blet/thread_pool.h"
+#include "blet/work_stealing_pool.h"
+
+static int leaves = 0;
+
+static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) +
+           static_cast<double>(ts.tv_nsec) / 1000000000.0;
+}
+
+static void report(const char* name, std::size_t workers, int tasks,
+                   double seconds) {
+    std::printf("%-20s %3lu workers %8d tasks %10.3f ms %12.0f tasks/s\n", name,
+                static_cast<unsigned long>(workers), tasks, seconds * 1000.0,
+                tasks / seconds);
+}
+
+// binary tree of fine-grained calls, each node submits its two children
+template<typename Pool>
+static void forkTree(Pool* pPool, int depth) {
+    if (depth == 0) {
+        __atomic_fetch_add(&leaves, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    pPool->submit(&forkTree<Pool>, pPool, depth - 1);
+    pPool->submit(&forkTree<Pool>, pPool, depth - 1);
+}
+
+static void benchThreadPool(int depth, std::size_t workers) {
+    blet::ThreadPool pool(workers);
+    double start = now();
+    pool.submit(&forkTree<blet::ThreadPool>, &pool, depth);
+    pool.wait();
+    report("thread-pool", workers, (2 << depth) - 1, now() - start);
+}
+
+static void benchWorkStealingPool(int depth, std::size_t workers) {
+    blet::WorkStealingPool pool(workers);
+    double start = now();
+    pool.submit(&forkTree<blet::WorkStealingPool>, &pool, depth);
+    pool.wait();
+    report("work-stealing-pool", workers, (2 << depth) - 1, now() - start);
+    blet::WorkStealingPool::Stats stats = pool.stats();
+    std::printf("%-20s local %lu steals %lu injected %lu\n", "",
+                stats.localHits, stats.steals, stats.injected);
+}
+
+int main(int argc, char* argv[]) {
+    int depth = argc > 1 ? std::atoi(argv[1]) : 18;
+    std::size_t maxWorkers =
+        argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 8;
+    for (std::size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        benchThreadPool(depth, workers);
+        benchWorkStealingPool(depth, workers);
+    }
+    return 0;
+}
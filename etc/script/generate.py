@@ -5,13 +5,15 @@ import os
 import sys
 from jinja2 import Environment, FileSystemLoader
 
-def generate_thread_file(nb_args):
+def generate_files(nb_args):
     # Create the jinja2 environment.
     # Notice the use of trim_blocks, which greatly helps control whitespace.
-    j2_env = Environment(loader=FileSystemLoader(os.path.dirname(os.path.abspath(__file__))),
+    script_dir = os.path.dirname(os.path.realpath(__file__))
+    j2_env = Environment(loader=FileSystemLoader(script_dir),
                          trim_blocks=True)
-    with open(os.path.dirname(os.path.realpath(__file__)) + '/../../include/blet/thread.h', 'w+') as f:
-        f.write(j2_env.get_template('thread.h.jinja').render(nb_args=nb_args))
+    for template in ['thread.h.jinja', 'future.h.jinja']:
+        with open(script_dir + '/../../include/blet/' + template[:-len('.jinja')], 'w+') as f:
+            f.write(j2_env.get_template(template).render(nb_args=nb_args))
 
 if __name__ == '__main__':
-    generate_thread_file(int(sys.argv[1]))
+    generate_files(int(sys.argv[1]))
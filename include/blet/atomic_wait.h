@@ -0,0 +1,102 @@
+/**
+ * atomic_wait.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_ATOMIC_WAIT_H_
+#define BLET_ATOMIC_WAIT_H_
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Block while *addr is expected, until woken by atomic_notify_one or
+ * atomic_notify_all on addr.
+ * Return at once when *addr already differs, may also return spuriously:
+ * callers re-check their condition in a loop.
+ */
+inline void atomic_wait(int* addr, int expected) {
+    Thread::futexWait(addr, expected);
+}
+
+/**
+ * Wake one thread blocked in atomic_wait on addr.
+ */
+inline void atomic_notify_one(int* addr) {
+    Thread::futexWake(addr, 1);
+}
+
+/**
+ * Wake all the threads blocked in atomic_wait on addr.
+ */
+inline void atomic_notify_all(int* addr) {
+    Thread::futexWake(addr);
+}
+
+/**
+ * Block the calling thread until unpark is called on its Thread.
+ * Each running thread owns one token in its thread-local storage: an unpark
+ * before park makes the next park return at once, several unpark before a
+ * park count as one.
+ * Return at once in a thread no Thread can unpark: one not started by a
+ * Thread, started detached or detached since.
+ */
+inline void park() {
+    int* pParkToken = &Thread::threadState().parkToken;
+    int state = __atomic_load_n(pParkToken, __ATOMIC_ACQUIRE);
+    while (state != Thread::PARK_UNOWNED) {
+        if (state == Thread::PARK_PARKED) {
+            Thread::futexWait(pParkToken, Thread::PARK_PARKED);
+            state = __atomic_load_n(pParkToken, __ATOMIC_ACQUIRE);
+        }
+        else if (__atomic_compare_exchange_n(
+                     pParkToken, &state,
+                     state == Thread::PARK_NOTIFIED ? Thread::PARK_EMPTY
+                                                    : Thread::PARK_PARKED,
+                     false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            if (state == Thread::PARK_NOTIFIED) {
+                return;
+            }
+            state = Thread::PARK_PARKED;
+        }
+    }
+}
+
+/**
+ * Make the token of the thread started by thread available and wake it if
+ * it is parked, only enters the kernel when it is.
+ * No effect before the thread is started and once it is joined or detached.
+ */
+inline void unpark(Thread& thread) {
+    Thread::ThreadState* pState = thread.runningState();
+    if (pState != NULL &&
+        __atomic_exchange_n(&pState->parkToken, Thread::PARK_NOTIFIED,
+                            __ATOMIC_RELEASE) == Thread::PARK_PARKED) {
+        Thread::futexWake(&pState->parkToken, 1);
+    }
+}
+
+} // namespace blet
+
+#endif // #ifndef BLET_ATOMIC_WAIT_H_
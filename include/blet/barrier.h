@@ -0,0 +1,162 @@
+/**
+ * barrier.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_BARRIER_H_
+#define BLET_BARRIER_H_
+
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+/**
+ * Default spins of Barrier and Latch waiters before they park on the futex.
+ */
+#ifndef BLET_BARRIER_SPIN
+#define BLET_BARRIER_SPIN 4000
+#endif
+
+namespace blet {
+
+/**
+ * Reusable sense-reversing barrier for a fixed number of threads.
+ * Each arrival decrements a counter, the last one resets it and flips the
+ * sense word the others wait on.
+ * Waiters spin on the sense for spinCount rounds then park on its futex,
+ * the last arrival only enters the kernel when one of them is parked.
+ */
+class Barrier {
+  public:
+    explicit Barrier(unsigned int count,
+                     unsigned int spinCount = BLET_BARRIER_SPIN) :
+        count_(static_cast<int>(count)),
+        spinCount_(spinCount),
+        remaining_(static_cast<int>(count)),
+        sense_(0),
+        sleepers_(0) {}
+
+    /**
+     * Wait for the count threads of the current phase.
+     * Return true in exactly one of them, the last to arrive.
+     */
+    bool arrive_and_wait() {
+        // cannot flip before this thread arrives
+        int sense = __atomic_load_n(&sense_, __ATOMIC_ACQUIRE);
+        if (__atomic_sub_fetch(&remaining_, 1, __ATOMIC_ACQ_REL) == 0) {
+            __atomic_store_n(&remaining_, count_, __ATOMIC_RELAXED);
+            // ordered with the increment of sleepers_ in wait
+            __atomic_store_n(&sense_, sense ^ 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&sleepers_, __ATOMIC_SEQ_CST) != 0) {
+                Thread::futexWake(&sense_);
+            }
+            return true;
+        }
+        wait(sense);
+        return false;
+    }
+
+    unsigned int count() const {
+        return static_cast<unsigned int>(count_);
+    }
+
+  private:
+    Barrier(const Barrier&);
+    Barrier& operator=(const Barrier&);
+
+    void wait(int sense) {
+        for (unsigned int i = 0; i < spinCount_; ++i) {
+            if (__atomic_load_n(&sense_, __ATOMIC_ACQUIRE) != sense) {
+                return;
+            }
+            cpu_relax();
+        }
+        __atomic_add_fetch(&sleepers_, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&sense_, __ATOMIC_SEQ_CST) == sense) {
+            Thread::futexWait(&sense_, sense);
+        }
+        __atomic_sub_fetch(&sleepers_, 1, __ATOMIC_RELAXED);
+    }
+
+    int count_;
+    unsigned int spinCount_;
+    // written by every arrival, away from the line the waiters spin on
+    char paddingRemaining_[64];
+    int remaining_;
+    char paddingSense_[64 - sizeof(int)];
+    int sense_;
+    int sleepers_;
+};
+
+/**
+ * One-shot countdown: wait returns once count_down brought the count to 0.
+ * Waiters spin for spinCount rounds then park on the futex of the count.
+ */
+class Latch {
+  public:
+    explicit Latch(unsigned int count,
+                   unsigned int spinCount = BLET_BARRIER_SPIN) :
+        count_(static_cast<int>(count)),
+        spinCount_(spinCount) {}
+
+    void count_down(unsigned int n = 1) {
+        if (__atomic_sub_fetch(&count_, static_cast<int>(n),
+                               __ATOMIC_ACQ_REL) == 0) {
+            // once in the life of the latch
+            Thread::futexWake(&count_);
+        }
+    }
+
+    bool try_wait() const {
+        return __atomic_load_n(&count_, __ATOMIC_ACQUIRE) == 0;
+    }
+
+    void wait() {
+        for (unsigned int i = 0; i < spinCount_; ++i) {
+            if (try_wait()) {
+                return;
+            }
+            cpu_relax();
+        }
+        int count = __atomic_load_n(&count_, __ATOMIC_ACQUIRE);
+        while (count != 0) {
+            Thread::futexWait(&count_, count);
+            count = __atomic_load_n(&count_, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    void arrive_and_wait(unsigned int n = 1) {
+        count_down(n);
+        wait();
+    }
+
+  private:
+    Latch(const Latch&);
+    Latch& operator=(const Latch&);
+
+    int count_;
+    unsigned int spinCount_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_BARRIER_H_
@@ -0,0 +1,1318 @@
+/**
+ * future.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// -------------------------------------------------------------------------
+// Generated by ./etc/script/generate.py 10
+// -------------------------------------------------------------------------
+
+#ifndef BLET_FUTURE_H_
+#define BLET_FUTURE_H_
+
+#include <cstddef>
+#include <new>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Part of the state shared by a Future and the thread computing its result
+ * that does not depend on the result type.
+ * The last of the two to release it destroys the whole block.
+ */
+struct FutureState {
+    enum Status {
+        FUTURE_PENDING,
+        FUTURE_READY,
+        // pending with at least one thread blocked in wait
+        FUTURE_WAITED
+    };
+
+    bool is_ready() const {
+        return __atomic_load_n(&status, __ATOMIC_ACQUIRE) == FUTURE_READY;
+    }
+
+    void wait() {
+        int expected = FUTURE_PENDING;
+        __atomic_compare_exchange_n(&status, &expected, FUTURE_WAITED, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&status, __ATOMIC_ACQUIRE) != FUTURE_READY) {
+            Thread::futexWait(&status, FUTURE_WAITED);
+        }
+    }
+
+    void set_ready() {
+        // only enter the kernel when somebody is waiting
+        if (__atomic_exchange_n(&status, FUTURE_READY, __ATOMIC_RELEASE) ==
+            FUTURE_WAITED) {
+            Thread::futexWake(&status);
+        }
+    }
+
+    void acquire() {
+        __atomic_add_fetch(&refCount, 1, __ATOMIC_RELAXED);
+    }
+
+    void release() {
+        if (__atomic_sub_fetch(&refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+            pDestroy(this);
+        }
+    }
+
+    int status;
+    int refCount;
+    void (*pDestroy)(FutureState*);
+    // thrown by the call instead of returning a result
+    CapturedException* pException;
+};
+
+/**
+ * Storage of the result, the value is constructed in place from the return of
+ * the bound call.
+ */
+template<typename R>
+struct FutureResult : public FutureState {
+    template<typename T>
+    void set(T& asyncData) {
+        new (storage.data) R(asyncData.call());
+    }
+    R& value() {
+        return *reinterpret_cast<R*>(storage.data);
+    }
+    void destroyValue() {
+        value().~R();
+    }
+    union Storage {
+        char data[sizeof(R)];
+        long double alignLongDouble;
+        void* alignPointer;
+    } storage;
+};
+
+template<typename R>
+struct FutureResult<R&> : public FutureState {
+    template<typename T>
+    void set(T& asyncData) {
+        pValue = &asyncData.call();
+    }
+    R& value() {
+        return *pValue;
+    }
+    void destroyValue() {}
+    R* pValue;
+};
+
+template<>
+struct FutureResult<void> : public FutureState {
+    template<typename T>
+    void set(T& asyncData) {
+        asyncData.call();
+    }
+    void value() {}
+    void destroyValue() {}
+};
+
+/**
+ * Single allocation of a launch: the shared state, the result and the bound
+ * call.
+ */
+template<typename R, typename T>
+struct FutureBlock : public FutureResult<R> {
+    explicit FutureBlock(const T& value) :
+        FutureResult<R>(),
+        asyncData(value) {
+        this->status = FutureState::FUTURE_PENDING;
+        // the future and the thread
+        this->refCount = 2;
+        this->pDestroy = &destroy;
+        this->pException = NULL;
+    }
+    static FutureBlock* create(const T& value) {
+        void* pMemory = ThreadDataPool::allocate(sizeof(FutureBlock));
+        try {
+            return new (pMemory) FutureBlock(value);
+        }
+        catch (...) {
+            ThreadDataPool::deallocate(pMemory, sizeof(FutureBlock));
+            throw;
+        }
+    }
+    void call() {
+        this->set(asyncData);
+    }
+    static void run(FutureBlock* pBlock) {
+        pBlock->pException = CapturedException::call(*pBlock);
+        pBlock->set_ready();
+        pBlock->release();
+    }
+    static void destroy(FutureState* pState) {
+        FutureBlock* pBlock = static_cast<FutureBlock*>(pState);
+        if (pBlock->pException != NULL) {
+            delete pBlock->pException;
+        }
+        else if (pBlock->is_ready()) {
+            pBlock->destroyValue();
+        }
+        ThreadDataPool::destroy(pBlock);
+    }
+    T asyncData;
+};
+
+/**
+ * Result of a call started by async.
+ * Copies share the same result, get can be called any number of times.
+ */
+template<typename R>
+class Future {
+  public:
+    Future() :
+        pState_(NULL) {}
+
+    Future(const Future& rhs) :
+        pState_(rhs.pState_) {
+        if (pState_ != NULL) {
+            pState_->acquire();
+        }
+    }
+
+    ~Future() {
+        if (pState_ != NULL) {
+            pState_->release();
+        }
+    }
+
+    Future& operator=(const Future& rhs) {
+        if (rhs.pState_ != NULL) {
+            rhs.pState_->acquire();
+        }
+        if (pState_ != NULL) {
+            pState_->release();
+        }
+        pState_ = rhs.pState_;
+        return *this;
+    }
+
+    /**
+     * False for a default constructed Future.
+     */
+    bool valid() const {
+        return pState_ != NULL;
+    }
+
+    bool is_ready() const {
+        return pState_->is_ready();
+    }
+
+    /**
+     * Block until the call has returned.
+     */
+    void wait() const {
+        if (!pState_->is_ready()) {
+            pState_->wait();
+        }
+    }
+
+    /**
+     * Block until the call has returned and give its result, or rethrow the
+     * exception that escaped it.
+     */
+    R get() const {
+        wait();
+        if (pState_->pException != NULL) {
+            pState_->pException->rethrow();
+        }
+        return pState_->value();
+    }
+
+    /**
+     * Start a detached thread running asyncData.call() and return the future
+     * of its result.
+     * The bound call and the shared state use one pooled allocation.
+     */
+    template<typename T>
+    static Future launch(const T& asyncData) {
+        FutureBlock<R, T>* pBlock = FutureBlock<R, T>::create(asyncData);
+        try {
+            Thread thread;
+            thread.start(&FutureBlock<R, T>::run, pBlock);
+            thread.detach();
+        }
+        catch (...) {
+            ThreadDataPool::destroy(pBlock);
+            throw;
+        }
+        return Future(pBlock);
+    }
+
+  private:
+    explicit Future(FutureResult<R>* pState) :
+        pState_(pState) {}
+
+    FutureResult<R>* pState_;
+};
+
+template<typename R>
+struct AsyncDataStatic0 {
+    AsyncDataStatic0(R (*pFunction)()) :
+        pFunction_(pFunction) {}
+    R call() {
+        return (*pFunction_)();
+    }
+    R (*pFunction_)();
+};
+
+template<typename R>
+Future<R> async(R (*pFunction)()) {
+    return Future<R>::launch(AsyncDataStatic0<R>(pFunction));
+}
+
+template<typename R, typename A1>
+struct AsyncDataStatic1 {
+    AsyncDataStatic1(R (*pFunction)(A1), A1 a1) :
+        pFunction_(pFunction),
+        a1_(a1) {}
+    R call() {
+        return (*pFunction_)(a1_);
+    }
+    R (*pFunction_)(A1);
+    A1 a1_;
+};
+
+template<typename R, typename A1>
+Future<R> async(R (*pFunction)(A1), A1 a1) {
+    return Future<R>::launch(AsyncDataStatic1<R, A1>(pFunction, a1));
+}
+
+template<typename R, typename A1, typename A2>
+struct AsyncDataStatic2 {
+    AsyncDataStatic2(R (*pFunction)(A1, A2), A1 a1, A2 a2) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_);
+    }
+    R (*pFunction_)(A1, A2);
+    A1 a1_;
+    A2 a2_;
+};
+
+template<typename R, typename A1, typename A2>
+Future<R> async(R (*pFunction)(A1, A2), A1 a1, A2 a2) {
+    return Future<R>::launch(AsyncDataStatic2<R, A1, A2>(pFunction, a1, a2));
+}
+
+template<typename R, typename A1, typename A2, typename A3>
+struct AsyncDataStatic3 {
+    AsyncDataStatic3(R (*pFunction)(A1, A2, A3), A1 a1, A2 a2, A3 a3) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_);
+    }
+    R (*pFunction_)(A1, A2, A3);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+};
+
+template<typename R, typename A1, typename A2, typename A3>
+Future<R> async(R (*pFunction)(A1, A2, A3), A1 a1, A2 a2, A3 a3) {
+    return Future<R>::launch(AsyncDataStatic3<R, A1, A2, A3>(
+        pFunction, a1, a2, a3));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4>
+struct AsyncDataStatic4 {
+    AsyncDataStatic4(R (*pFunction)(A1, A2, A3, A4), A1 a1, A2 a2, A3 a3,
+                     A4 a4) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4), A1 a1, A2 a2, A3 a3, A4 a4) {
+    return Future<R>::launch(AsyncDataStatic4<R, A1, A2, A3, A4>(
+        pFunction, a1, a2, a3, a4));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5>
+struct AsyncDataStatic5 {
+    AsyncDataStatic5(R (*pFunction)(A1, A2, A3, A4, A5), A1 a1, A2 a2, A3 a3,
+                     A4 a4, A5 a5) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5), A1 a1, A2 a2, A3 a3, A4 a4,
+                A5 a5) {
+    return Future<R>::launch(AsyncDataStatic5<R, A1, A2, A3, A4, A5>(
+        pFunction, a1, a2, a3, a4, a5));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6>
+struct AsyncDataStatic6 {
+    AsyncDataStatic6(R (*pFunction)(A1, A2, A3, A4, A5, A6), A1 a1, A2 a2,
+                     A3 a3, A4 a4, A5 a5, A6 a6) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5, A6);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5, A6), A1 a1, A2 a2, A3 a3,
+                A4 a4, A5 a5, A6 a6) {
+    return Future<R>::launch(AsyncDataStatic6<R, A1, A2, A3, A4, A5, A6>(
+        pFunction, a1, a2, a3, a4, a5, a6));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7>
+struct AsyncDataStatic7 {
+    AsyncDataStatic7(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7), A1 a1, A2 a2,
+                     A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5, A6, A7);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7), A1 a1, A2 a2, A3 a3,
+                A4 a4, A5 a5, A6 a6, A7 a7) {
+    return Future<R>::launch(AsyncDataStatic7<R, A1, A2, A3, A4, A5, A6, A7>(
+        pFunction, a1, a2, a3, a4, a5, a6, a7));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8>
+struct AsyncDataStatic8 {
+    AsyncDataStatic8(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8), A1 a1,
+                     A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8), A1 a1, A2 a2,
+                A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) {
+    return Future<R>::launch(AsyncDataStatic8<R, A1, A2, A3, A4, A5, A6, A7,
+                                              A8>(
+        pFunction, a1, a2, a3, a4, a5, a6, a7, a8));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8, typename A9>
+struct AsyncDataStatic9 {
+    AsyncDataStatic9(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9), A1 a1,
+                     A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8, typename A9>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9), A1 a1,
+                A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) {
+    return Future<R>::launch(AsyncDataStatic9<R, A1, A2, A3, A4, A5, A6, A7, A8,
+                                              A9>(
+        pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+}
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8, typename A9,
+         typename A10>
+struct AsyncDataStatic10 {
+    AsyncDataStatic10(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10),
+                      A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8,
+                      A9 a9, A10 a10) :
+        pFunction_(pFunction),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9),
+        a10_(a10) {}
+    R call() {
+        return (*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_, a9_, a10_);
+    }
+    R (*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10);
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+    A10 a10_;
+};
+
+template<typename R, typename A1, typename A2, typename A3, typename A4,
+         typename A5, typename A6, typename A7, typename A8, typename A9,
+         typename A10>
+Future<R> async(R (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10), A1 a1,
+                A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
+                A10 a10) {
+    return Future<R>::launch(AsyncDataStatic10<R, A1, A2, A3, A4, A5, A6, A7,
+                                               A8, A9, A10>(
+        pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+}
+
+template<typename R, typename Class>
+struct AsyncDataMethod0 {
+    AsyncDataMethod0(R (Class::*pFunction)(), Class* pObject) :
+        pFunction_(pFunction),
+        pObject_(pObject) {}
+    R call() {
+        return (pObject_->*pFunction_)();
+    }
+    R (Class::*pFunction_)();
+    Class* pObject_;
+};
+
+template<typename R, typename Class>
+Future<R> async(R (Class::*pFunction)(), Class* pObject) {
+    return Future<R>::launch(AsyncDataMethod0<R, Class>(pFunction, pObject));
+}
+
+template<typename R, typename Class, typename A1>
+struct AsyncDataMethod1 {
+    AsyncDataMethod1(R (Class::*pFunction)(A1), Class* pObject, A1 a1) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_);
+    }
+    R (Class::*pFunction_)(A1);
+    Class* pObject_;
+    A1 a1_;
+};
+
+template<typename R, typename Class, typename A1>
+Future<R> async(R (Class::*pFunction)(A1), Class* pObject, A1 a1) {
+    return Future<R>::launch(AsyncDataMethod1<R, Class, A1>(
+        pFunction, pObject, a1));
+}
+
+template<typename R, typename Class, typename A1, typename A2>
+struct AsyncDataMethod2 {
+    AsyncDataMethod2(R (Class::*pFunction)(A1, A2), Class* pObject, A1 a1,
+                     A2 a2) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_);
+    }
+    R (Class::*pFunction_)(A1, A2);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+};
+
+template<typename R, typename Class, typename A1, typename A2>
+Future<R> async(R (Class::*pFunction)(A1, A2), Class* pObject, A1 a1, A2 a2) {
+    return Future<R>::launch(AsyncDataMethod2<R, Class, A1, A2>(
+        pFunction, pObject, a1, a2));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3>
+struct AsyncDataMethod3 {
+    AsyncDataMethod3(R (Class::*pFunction)(A1, A2, A3), Class* pObject, A1 a1,
+                     A2 a2, A3 a3) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3), Class* pObject, A1 a1, A2 a2,
+                A3 a3) {
+    return Future<R>::launch(AsyncDataMethod3<R, Class, A1, A2, A3>(
+        pFunction, pObject, a1, a2, a3));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4>
+struct AsyncDataMethod4 {
+    AsyncDataMethod4(R (Class::*pFunction)(A1, A2, A3, A4), Class* pObject,
+                     A1 a1, A2 a2, A3 a3, A4 a4) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4), Class* pObject, A1 a1,
+                A2 a2, A3 a3, A4 a4) {
+    return Future<R>::launch(AsyncDataMethod4<R, Class, A1, A2, A3, A4>(
+        pFunction, pObject, a1, a2, a3, a4));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5>
+struct AsyncDataMethod5 {
+    AsyncDataMethod5(R (Class::*pFunction)(A1, A2, A3, A4, A5), Class* pObject,
+                     A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5), Class* pObject,
+                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
+    return Future<R>::launch(AsyncDataMethod5<R, Class, A1, A2, A3, A4, A5>(
+        pFunction, pObject, a1, a2, a3, a4, a5));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6>
+struct AsyncDataMethod6 {
+    AsyncDataMethod6(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6),
+                     Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6), Class* pObject,
+                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) {
+    return Future<R>::launch(AsyncDataMethod6<R, Class, A1, A2, A3, A4, A5, A6>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7>
+struct AsyncDataMethod7 {
+    AsyncDataMethod7(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7),
+                     Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                     A7 a7) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7) {
+    return Future<R>::launch(AsyncDataMethod7<R, Class, A1, A2, A3, A4, A5, A6,
+                                              A7>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8>
+struct AsyncDataMethod8 {
+    AsyncDataMethod8(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8),
+                     Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                     A7 a7, A8 a8) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8) {
+    return Future<R>::launch(AsyncDataMethod8<R, Class, A1, A2, A3, A4, A5, A6,
+                                              A7, A8>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9>
+struct AsyncDataMethod9 {
+    AsyncDataMethod9(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9),
+                     Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                     A7 a7, A8 a8, A9 a9) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_,
+                                       a9_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8, A9 a9) {
+    return Future<R>::launch(AsyncDataMethod9<R, Class, A1, A2, A3, A4, A5, A6,
+                                              A7, A8, A9>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9, typename A10>
+struct AsyncDataMethod10 {
+    AsyncDataMethod10(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9,
+                                            A10), Class* pObject, A1 a1, A2 a2,
+                      A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
+                      A10 a10) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9),
+        a10_(a10) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_,
+                                       a9_, a10_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10);
+    Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+    A10 a10_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9, typename A10>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8, A9 a9, A10 a10) {
+    return Future<R>::launch(AsyncDataMethod10<R, Class, A1, A2, A3, A4, A5, A6,
+                                               A7, A8, A9, A10>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+}
+
+template<typename R, typename Class>
+struct AsyncDataMethodConst0 {
+    AsyncDataMethodConst0(R (Class::*pFunction)() const, const Class* pObject) :
+        pFunction_(pFunction),
+        pObject_(pObject) {}
+    R call() {
+        return (pObject_->*pFunction_)();
+    }
+    R (Class::*pFunction_)() const;
+    const Class* pObject_;
+};
+
+template<typename R, typename Class>
+Future<R> async(R (Class::*pFunction)() const, const Class* pObject) {
+    return Future<R>::launch(AsyncDataMethodConst0<R, Class>(
+        pFunction, pObject));
+}
+
+template<typename R, typename Class, typename A1>
+struct AsyncDataMethodConst1 {
+    AsyncDataMethodConst1(R (Class::*pFunction)(A1) const, const Class* pObject,
+                          A1 a1) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_);
+    }
+    R (Class::*pFunction_)(A1) const;
+    const Class* pObject_;
+    A1 a1_;
+};
+
+template<typename R, typename Class, typename A1>
+Future<R> async(R (Class::*pFunction)(A1) const, const Class* pObject, A1 a1) {
+    return Future<R>::launch(AsyncDataMethodConst1<R, Class, A1>(
+        pFunction, pObject, a1));
+}
+
+template<typename R, typename Class, typename A1, typename A2>
+struct AsyncDataMethodConst2 {
+    AsyncDataMethodConst2(R (Class::*pFunction)(A1, A2) const,
+                          const Class* pObject, A1 a1, A2 a2) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_);
+    }
+    R (Class::*pFunction_)(A1, A2) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+};
+
+template<typename R, typename Class, typename A1, typename A2>
+Future<R> async(R (Class::*pFunction)(A1, A2) const, const Class* pObject,
+                A1 a1, A2 a2) {
+    return Future<R>::launch(AsyncDataMethodConst2<R, Class, A1, A2>(
+        pFunction, pObject, a1, a2));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3>
+struct AsyncDataMethodConst3 {
+    AsyncDataMethodConst3(R (Class::*pFunction)(A1, A2, A3) const,
+                          const Class* pObject, A1 a1, A2 a2, A3 a3) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3) const, const Class* pObject,
+                A1 a1, A2 a2, A3 a3) {
+    return Future<R>::launch(AsyncDataMethodConst3<R, Class, A1, A2, A3>(
+        pFunction, pObject, a1, a2, a3));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4>
+struct AsyncDataMethodConst4 {
+    AsyncDataMethodConst4(R (Class::*pFunction)(A1, A2, A3, A4) const,
+                          const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4) {
+    return Future<R>::launch(AsyncDataMethodConst4<R, Class, A1, A2, A3, A4>(
+        pFunction, pObject, a1, a2, a3, a4));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5>
+struct AsyncDataMethodConst5 {
+    AsyncDataMethodConst5(R (Class::*pFunction)(A1, A2, A3, A4, A5) const,
+                          const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4,
+                          A5 a5) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
+    return Future<R>::launch(AsyncDataMethodConst5<R, Class, A1, A2, A3, A4,
+                                                   A5>(
+        pFunction, pObject, a1, a2, a3, a4, a5));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6>
+struct AsyncDataMethodConst6 {
+    AsyncDataMethodConst6(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6) const,
+                          const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4,
+                          A5 a5, A6 a6) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5,
+                A6 a6) {
+    return Future<R>::launch(AsyncDataMethodConst6<R, Class, A1, A2, A3, A4, A5,
+                                                   A6>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7>
+struct AsyncDataMethodConst7 {
+    AsyncDataMethodConst7(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6,
+                                                A7) const, const Class* pObject,
+                          A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7) {
+    return Future<R>::launch(AsyncDataMethodConst7<R, Class, A1, A2, A3, A4, A5,
+                                                   A6, A7>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8>
+struct AsyncDataMethodConst8 {
+    AsyncDataMethodConst8(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7,
+                                                A8) const, const Class* pObject,
+                          A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                          A8 a8) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7, A8 a8) {
+    return Future<R>::launch(AsyncDataMethodConst8<R, Class, A1, A2, A3, A4, A5,
+                                                   A6, A7, A8>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9>
+struct AsyncDataMethodConst9 {
+    AsyncDataMethodConst9(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8,
+                                                A9) const, const Class* pObject,
+                          A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                          A8 a8, A9 a9) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_,
+                                       a9_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7, A8 a8, A9 a9) {
+    return Future<R>::launch(AsyncDataMethodConst9<R, Class, A1, A2, A3, A4, A5,
+                                                   A6, A7, A8, A9>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+}
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9, typename A10>
+struct AsyncDataMethodConst10 {
+    AsyncDataMethodConst10(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8,
+                                                 A9, A10) const,
+                           const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4,
+                           A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) :
+        pFunction_(pFunction),
+        pObject_(pObject),
+        a1_(a1),
+        a2_(a2),
+        a3_(a3),
+        a4_(a4),
+        a5_(a5),
+        a6_(a6),
+        a7_(a7),
+        a8_(a8),
+        a9_(a9),
+        a10_(a10) {}
+    R call() {
+        return (pObject_->*pFunction_)(a1_, a2_, a3_, a4_, a5_, a6_, a7_, a8_,
+                                       a9_, a10_);
+    }
+    R (Class::*pFunction_)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10) const;
+    const Class* pObject_;
+    A1 a1_;
+    A2 a2_;
+    A3 a3_;
+    A4 a4_;
+    A5 a5_;
+    A6 a6_;
+    A7 a7_;
+    A8 a8_;
+    A9 a9_;
+    A10 a10_;
+};
+
+template<typename R, typename Class, typename A1, typename A2, typename A3,
+         typename A4, typename A5, typename A6, typename A7, typename A8,
+         typename A9, typename A10>
+Future<R> async(R (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9,
+                                      A10) const, const Class* pObject, A1 a1,
+                A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
+                A10 a10) {
+    return Future<R>::launch(AsyncDataMethodConst10<R, Class, A1, A2, A3, A4,
+                                                    A5, A6, A7, A8, A9, A10>(
+        pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+}
+
+} // namespace blet
+
+#endif // #ifndef BLET_FUTURE_H_
@@ -0,0 +1,182 @@
+/**
+ * mcs_lock.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_MCS_LOCK_H_
+#define BLET_MCS_LOCK_H_
+
+#include <sched.h>
+
+#include <cstddef>
+#include <cstdlib>
+
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+/**
+ * Number of McsLock a thread can hold at the same time through lock().
+ */
+#ifndef BLET_MCS_LOCK_DEPTH
+#define BLET_MCS_LOCK_DEPTH 16
+#endif
+
+/**
+ * Spins of a waiter on its own node before it parks.
+ */
+#ifndef BLET_MCS_LOCK_SPIN
+#define BLET_MCS_LOCK_SPIN 1000
+#endif
+
+namespace blet {
+
+/**
+ * MCS queue lock: each waiter spins on its own cache line padded node and
+ * the owner hands the lock to the next node, in FIFO order.
+ * An acquire touches the shared tail once, whatever the number of waiters.
+ * A waiter still spinning after BLET_MCS_LOCK_SPIN parks on its node.
+ * lock() takes its node from a thread-local cache, locks held at the same
+ * time by a thread must be released in reverse order.
+ */
+class McsLock {
+  public:
+    struct Node {
+        Node* pNext;
+        int state;
+    } __attribute__((aligned(64)));
+
+    McsLock() :
+        pTail_(NULL) {}
+
+    void lock() {
+        NodeCache& cache = nodeCache();
+        if (cache.depth == BLET_MCS_LOCK_DEPTH) {
+            // more locks held than BLET_MCS_LOCK_DEPTH
+            std::abort();
+        }
+        lock(&cache.nodes[cache.depth++]);
+    }
+
+    bool try_lock() {
+        NodeCache& cache = nodeCache();
+        if (cache.depth == BLET_MCS_LOCK_DEPTH ||
+            !try_lock(&cache.nodes[cache.depth])) {
+            return false;
+        }
+        ++cache.depth;
+        return true;
+    }
+
+    void unlock() {
+        NodeCache& cache = nodeCache();
+        unlock(&cache.nodes[--cache.depth]);
+    }
+
+    /**
+     * pNode is owned by the lock until the matching unlock.
+     */
+    void lock(Node* pNode) {
+        pNode->pNext = NULL;
+        pNode->state = WAITING;
+        Node* pPrev = __atomic_exchange_n(&pTail_, pNode, __ATOMIC_ACQ_REL);
+        if (pPrev != NULL) {
+            __atomic_store_n(&pPrev->pNext, pNode, __ATOMIC_RELEASE);
+            wait(pNode);
+        }
+    }
+
+    bool try_lock(Node* pNode) {
+        pNode->pNext = NULL;
+        Node* pExpected = NULL;
+        return __atomic_compare_exchange_n(&pTail_, &pExpected, pNode, false,
+                                           __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED);
+    }
+
+    void unlock(Node* pNode) {
+        Node* pNext = __atomic_load_n(&pNode->pNext, __ATOMIC_ACQUIRE);
+        if (pNext == NULL) {
+            Node* pExpected = pNode;
+            if (__atomic_compare_exchange_n(&pTail_, &pExpected,
+                                            static_cast<Node*>(NULL), false,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+                return;
+            }
+            // the next waiter has swapped the tail but not linked its node
+            while ((pNext = __atomic_load_n(&pNode->pNext,
+                                            __ATOMIC_ACQUIRE)) == NULL) {
+                ::sched_yield();
+            }
+        }
+        if (__atomic_exchange_n(&pNext->state, GRANTED, __ATOMIC_RELEASE) ==
+            PARKED) {
+            Thread::futexWake(&pNext->state, 1);
+        }
+    }
+
+  private:
+    McsLock(const McsLock&);
+    McsLock& operator=(const McsLock&);
+
+    enum State {
+        GRANTED,
+        WAITING,
+        PARKED
+    };
+
+    struct NodeCache {
+        Node nodes[BLET_MCS_LOCK_DEPTH];
+        std::size_t depth;
+    };
+
+    static NodeCache& nodeCache() {
+        static __thread NodeCache cache;
+        return cache;
+    }
+
+    static void wait(Node* pNode) {
+        for (int i = 0; i < BLET_MCS_LOCK_SPIN; ++i) {
+            if (__atomic_load_n(&pNode->state, __ATOMIC_ACQUIRE) == GRANTED) {
+                return;
+            }
+            cpu_relax();
+        }
+        int expected = WAITING;
+        __atomic_compare_exchange_n(&pNode->state, &expected, PARKED, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&pNode->state, __ATOMIC_ACQUIRE) != GRANTED) {
+            Thread::futexWait(&pNode->state, PARKED);
+        }
+    }
+
+    // alone on its cache line, written once per acquire
+    char paddingBefore_[64];
+    Node* pTail_;
+    char paddingTail_[64 - sizeof(Node*)];
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_MCS_LOCK_H_
@@ -0,0 +1,234 @@
+/**
+ * mpmc_queue.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_MPMC_QUEUE_H_
+#define BLET_MPMC_QUEUE_H_
+
+#include <sched.h>
+
+#include <cstddef>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Bounded multi-producer multi-consumer queue.
+ * Each cell carries a sequence number telling whether it is ready for the
+ * next push or the next pop, so producers and consumers only contend on their
+ * own position with a single compare and swap.
+ * The capacity is rounded up to a power of two.
+ * push and pop spin for a while then park the caller on a futex until a cell
+ * is released.
+ */
+template<typename T>
+class MpmcQueue {
+  public:
+    explicit MpmcQueue(std::size_t capacity) :
+        cells_(NULL),
+        mask_(0),
+        tail_(0),
+        head_(0),
+        pushWaiters_(0),
+        popWaiters_(0),
+        pushEvent_(0),
+        popEvent_(0) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = new Cell[size];
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence = i;
+        }
+    }
+
+    ~MpmcQueue() {
+        delete[] cells_;
+    }
+
+    std::size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * Approximate number of values when other threads are using the queue.
+     */
+    std::size_t size() const {
+        std::size_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        return tail - head <= mask_ + 1 ? tail - head : 0;
+    }
+
+    /**
+     * Return false when the queue is full.
+     */
+    bool try_push(const T& value) {
+        std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        for (;;) {
+            Cell* pCell = &cells_[tail & mask_];
+            std::size_t sequence =
+                __atomic_load_n(&pCell->sequence, __ATOMIC_ACQUIRE);
+            long diff = static_cast<long>(sequence - tail);
+            if (diff == 0) {
+                if (__atomic_compare_exchange_n(&tail_, &tail, tail + 1, true,
+                                                __ATOMIC_SEQ_CST,
+                                                __ATOMIC_RELAXED)) {
+                    pCell->value = value;
+                    __atomic_store_n(&pCell->sequence, tail + 1,
+                                     __ATOMIC_RELEASE);
+                    notify(&popWaiters_, &pushEvent_);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /**
+     * Return false when the queue is empty.
+     */
+    bool try_pop(T& value) {
+        std::size_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        for (;;) {
+            Cell* pCell = &cells_[head & mask_];
+            std::size_t sequence =
+                __atomic_load_n(&pCell->sequence, __ATOMIC_ACQUIRE);
+            long diff = static_cast<long>(sequence - (head + 1));
+            if (diff == 0) {
+                if (__atomic_compare_exchange_n(&head_, &head, head + 1, true,
+                                                __ATOMIC_SEQ_CST,
+                                                __ATOMIC_RELAXED)) {
+                    value = pCell->value;
+                    __atomic_store_n(&pCell->sequence, head + mask_ + 1,
+                                     __ATOMIC_RELEASE);
+                    notify(&pushWaiters_, &popEvent_);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /**
+     * Wait until a cell is free.
+     */
+    void push(const T& value) {
+        for (;;) {
+            for (int i = 0; i < SPIN_COUNT; ++i) {
+                if (try_push(value)) {
+                    return;
+                }
+                ::sched_yield();
+            }
+            int event = __atomic_load_n(&popEvent_, __ATOMIC_ACQUIRE);
+            __atomic_add_fetch(&pushWaiters_, 1, __ATOMIC_SEQ_CST);
+            // a pop ordered before the increment moved head_, a pop ordered
+            // after it sees the waiter and changes popEvent_
+            std::size_t head = __atomic_load_n(&head_, __ATOMIC_SEQ_CST);
+            std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+            if (tail - head > mask_) {
+                Thread::futexWait(&popEvent_, event);
+            }
+            __atomic_sub_fetch(&pushWaiters_, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    /**
+     * Wait until a value is available.
+     */
+    void pop(T& value) {
+        for (;;) {
+            for (int i = 0; i < SPIN_COUNT; ++i) {
+                if (try_pop(value)) {
+                    return;
+                }
+                ::sched_yield();
+            }
+            int event = __atomic_load_n(&pushEvent_, __ATOMIC_ACQUIRE);
+            __atomic_add_fetch(&popWaiters_, 1, __ATOMIC_SEQ_CST);
+            // same handshake as push
+            std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_SEQ_CST);
+            std::size_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+            if (tail == head) {
+                Thread::futexWait(&pushEvent_, event);
+            }
+            __atomic_sub_fetch(&popWaiters_, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+  private:
+    MpmcQueue(const MpmcQueue&);
+    MpmcQueue& operator=(const MpmcQueue&);
+
+    enum {
+        // try_push or try_pop attempts before parking
+        SPIN_COUNT = 16
+    };
+
+    struct Cell {
+        std::size_t sequence;
+        T value;
+    };
+
+    static void notify(int* pWaiters, int* pEvent) {
+        if (__atomic_load_n(pWaiters, __ATOMIC_SEQ_CST) != 0) {
+            __atomic_add_fetch(pEvent, 1, __ATOMIC_RELEASE);
+            Thread::futexWake(pEvent);
+        }
+    }
+
+    // read-only after construction
+    char paddingCells_[64];
+    Cell* cells_;
+    std::size_t mask_;
+    char paddingTail_[64 - sizeof(Cell*) - sizeof(std::size_t)];
+    // next push position
+    std::size_t tail_;
+    char paddingHead_[64 - sizeof(std::size_t)];
+    // next pop position
+    std::size_t head_;
+    char paddingWaiters_[64 - sizeof(std::size_t)];
+    int pushWaiters_;
+    int popWaiters_;
+    int pushEvent_;
+    int popEvent_;
+    char paddingEnd_[64 - 4 * sizeof(int)];
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_MPMC_QUEUE_H_
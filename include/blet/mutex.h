@@ -0,0 +1,158 @@
+/**
+ * mutex.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_MUTEX_H_
+#define BLET_MUTEX_H_
+
+#include "blet/thread.h"
+
+/**
+ * Upper bound of the adaptive spin of Mutex::lock before it parks.
+ */
+#ifndef BLET_MUTEX_MAX_SPIN
+#define BLET_MUTEX_MAX_SPIN 100
+#endif
+
+namespace blet {
+
+/**
+ * Hint for the core running a spin-wait loop.
+ */
+inline void cpu_relax() {
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Mutex on a single futex word: unlocked, locked, or locked with parked
+ * waiters.
+ * An uncontended lock and unlock are one atomic each, unlock only enters the
+ * kernel when a waiter is parked.
+ * A contended lock first spins for as long as recent locks had to wait, up
+ * to BLET_MUTEX_MAX_SPIN, then parks.
+ */
+class Mutex {
+  public:
+    Mutex() :
+        state_(UNLOCKED),
+        spin_(0) {}
+
+    void lock() {
+        int expected = UNLOCKED;
+        if (!__atomic_compare_exchange_n(&state_, &expected, LOCKED, false,
+                                         __ATOMIC_ACQUIRE,
+                                         __ATOMIC_RELAXED)) {
+            lockSlow();
+        }
+    }
+
+    bool try_lock() {
+        int expected = UNLOCKED;
+        return __atomic_compare_exchange_n(&state_, &expected, LOCKED, false,
+                                           __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED);
+    }
+
+    void unlock() {
+        if (__atomic_exchange_n(&state_, UNLOCKED, __ATOMIC_RELEASE) ==
+            CONTENDED) {
+            Thread::futexWake(&state_, 1);
+        }
+    }
+
+  private:
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+
+    enum State {
+        UNLOCKED,
+        LOCKED,
+        // locked with waiters that may be parked
+        CONTENDED
+    };
+
+    void lockSlow() {
+        // estimate kept like PTHREAD_MUTEX_ADAPTIVE_NP
+        int spin = __atomic_load_n(&spin_, __ATOMIC_RELAXED);
+        int maxSpin = spin * 2 + 10;
+        if (maxSpin > BLET_MUTEX_MAX_SPIN) {
+            maxSpin = BLET_MUTEX_MAX_SPIN;
+        }
+        int count = 0;
+        for (; count < maxSpin; ++count) {
+            int state = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+            if (state == CONTENDED) {
+                // others are parked already
+                break;
+            }
+            if (state == UNLOCKED && try_lock()) {
+                __atomic_store_n(&spin_, spin + (count - spin) / 8,
+                                 __ATOMIC_RELAXED);
+                return;
+            }
+            cpu_relax();
+        }
+        __atomic_store_n(&spin_, spin + (count - spin) / 8, __ATOMIC_RELAXED);
+        // this thread cannot tell whether it was the only waiter, the next
+        // unlock wakes in doubt
+        while (__atomic_exchange_n(&state_, CONTENDED, __ATOMIC_ACQUIRE) !=
+               UNLOCKED) {
+            Thread::futexWait(&state_, CONTENDED);
+        }
+    }
+
+    int state_;
+    int spin_;
+};
+
+/**
+ * Scoped lock for any type with lock and unlock.
+ */
+template<typename M>
+class LockGuard {
+  public:
+    explicit LockGuard(M& mutex) :
+        mutex_(mutex) {
+        mutex_.lock();
+    }
+
+    ~LockGuard() {
+        mutex_.unlock();
+    }
+
+  private:
+    LockGuard(const LockGuard&);
+    LockGuard& operator=(const LockGuard&);
+
+    M& mutex_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_MUTEX_H_
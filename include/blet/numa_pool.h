@@ -0,0 +1,441 @@
+/**
+ * numa_pool.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_NUMA_POOL_H_
+#define BLET_NUMA_POOL_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "blet/thread.h"
+#include "blet/topology.h"
+
+namespace blet {
+
+/**
+ * Fixed groups of Thread workers, one group per NUMA node read from
+ * /sys/devices/system/node (Linux), each one with its own queue of Task.
+ * The workers of a node are pinned to its CPUs and their state is allocated
+ * on its memory.
+ * A call goes to the queue of the node given to node(), else to the node of
+ * the submitting worker, else to the node of the CPU running the caller.
+ * An idle worker takes from its node, then steals from the other nodes, and
+ * parks when every queue is empty.
+ * Without sysfs, the pool has a single node holding every allowed CPU.
+ * The destructor runs the remaining calls before stopping the workers.
+ */
+class NumaPool : public PoolExecutor<NumaPool> {
+  public:
+    struct Stats {
+        // calls run by a worker of the node they were queued on
+        unsigned long localTasks;
+        // calls stolen from the queue of another node
+        unsigned long remoteTasks;
+    };
+
+    /**
+     * Submit to the queue of one node, see NumaPool::node.
+     */
+    class NodeExecutor : public Executor<NodeExecutor> {
+      private:
+        friend class NumaPool;
+        friend class Executor<NodeExecutor>;
+
+        NodeExecutor() :
+            pPool_(NULL),
+            index_(0) {}
+
+        void push(const Task& task) {
+            pPool_->pushNode(index_, task);
+        }
+
+        NumaPool* pPool_;
+        std::size_t index_;
+    };
+
+    /**
+     * Start workersPerNode workers on each node with CPUs, or one per CPU
+     * of the node when it is 0.
+     * root is the sysfs node directory.
+     */
+    explicit NumaPool(std::size_t workersPerNode = 0,
+                      const char* root = "/sys/devices/system/node") :
+        nodes_(NULL),
+        nodeCount_(0),
+        threads_(NULL),
+        workers_(NULL),
+        size_(0),
+        queued_(0),
+        sleepers_(NULL) {
+        std::vector<int> ids;
+        std::vector<cpu_set_t> cpus;
+        discover(root, &ids, &cpus);
+        nodeCount_ = ids.size();
+        try {
+            nodes_ = new Node[nodeCount_];
+            sleepers_ = new Sleepers[nodeCount_];
+            for (std::size_t i = 0; i < nodeCount_; ++i) {
+                nodes_[i].id = ids[i];
+                nodes_[i].cpus = cpus[i];
+                nodes_[i].executor.pPool_ = this;
+                nodes_[i].executor.index_ = i;
+                nodes_[i].workerCount = workersPerNode != 0
+                                            ? workersPerNode
+                                            : CPU_COUNT(&nodes_[i].cpus);
+                size_ += nodes_[i].workerCount;
+            }
+            workers_ = new Worker*[size_];
+            for (std::size_t i = 0; i < size_; ++i) {
+                workers_[i] = NULL;
+            }
+            threads_ = new Thread[size_];
+            std::size_t index = 0;
+            for (std::size_t i = 0; i < nodeCount_; ++i) {
+                Thread::Attributes attributes;
+                attributes.set_affinity(nodes_[i].cpus);
+                for (std::size_t j = 0; j < nodes_[i].workerCount; ++j) {
+                    void* pMemory = allocate_on_node(sizeof(Worker), ids[i]);
+                    if (pMemory == NULL) {
+                        throw std::bad_alloc();
+                    }
+                    workers_[index] = new (pMemory) Worker(i);
+                    threads_[index].set_attributes(attributes);
+                    threads_[index].start(&NumaPool::run, this,
+                                          workers_[index]);
+                    ++index;
+                }
+            }
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~NumaPool() {
+        stop();
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t node_count() const {
+        return nodeCount_;
+    }
+
+    /**
+     * sysfs id of the node at index.
+     */
+    int node_id(std::size_t index) const {
+        return nodes_[index].id;
+    }
+
+    /**
+     * CPUs of the node at index used by its workers.
+     */
+    const cpu_set_t& node_cpus(std::size_t index) const {
+        return nodes_[index].cpus;
+    }
+
+    /**
+     * Executor queuing its calls on the node at index, to run them next to
+     * the memory they use.
+     */
+    NodeExecutor& node(std::size_t index) {
+        return nodes_[index].executor;
+    }
+
+    /**
+     * Index of the node of the calling worker, -1 outside of the workers.
+     */
+    static int current_node() {
+        Worker* pWorker = static_cast<Worker*>(currentWorker());
+        return pWorker != NULL ? static_cast<int>(pWorker->node) : -1;
+    }
+
+    Stats stats() const {
+        Stats result;
+        result.localTasks = 0;
+        result.remoteTasks = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            result.localTasks +=
+                __atomic_load_n(&workers_[i]->localTasks, __ATOMIC_RELAXED);
+            result.remoteTasks +=
+                __atomic_load_n(&workers_[i]->remoteTasks, __ATOMIC_RELAXED);
+        }
+        return result;
+    }
+
+    /**
+     * Map size bytes preferably placed on the memory of the node with this
+     * sysfs id, NULL when the mapping fails.
+     * Without NUMA support in the kernel, the pages land on the node of the
+     * thread touching them first.
+     */
+    static void* allocate_on_node(std::size_t size, int nodeId) {
+        void* pMemory = ::mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pMemory == MAP_FAILED) {
+            return NULL;
+        }
+#ifdef SYS_mbind
+        if (nodeId >= 0 && nodeId < MAX_NODES) {
+            unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+            mask[nodeId / (8 * sizeof(unsigned long))] |=
+                1UL << (nodeId % (8 * sizeof(unsigned long)));
+            // MPOL_PREFERRED, falls back to other nodes when it is full
+            ::syscall(SYS_mbind, pMemory, size, 1, mask, MAX_NODES + 1, 0);
+        }
+#endif
+        return pMemory;
+    }
+
+    static void deallocate_on_node(void* pMemory, std::size_t size) {
+        ::munmap(pMemory, size);
+    }
+
+  private:
+    friend class Executor<NumaPool>;
+    friend class PoolExecutor<NumaPool>;
+
+    NumaPool(const NumaPool&);
+    NumaPool& operator=(const NumaPool&);
+
+    enum {
+        // node ids given to mbind
+        MAX_NODES = 1024
+    };
+
+    struct Node {
+        Node() :
+            id(0),
+            workerCount(0),
+            size(0) {
+            CPU_ZERO(&cpus);
+            ::pthread_mutex_init(&mutex, NULL);
+        }
+        ~Node() {
+            ::pthread_mutex_destroy(&mutex);
+        }
+        int id;
+        cpu_set_t cpus;
+        std::size_t workerCount;
+        NodeExecutor executor;
+        std::deque<Task> tasks;
+        // tasks.size() readable without the mutex
+        std::size_t size;
+        ::pthread_mutex_t mutex;
+        char padding[64];
+    };
+
+    struct Worker : public WorkerState {
+        explicit Worker(std::size_t nodeIndex) :
+            node(nodeIndex),
+            localTasks(0),
+            remoteTasks(0) {}
+        std::size_t node;
+        unsigned long localTasks;
+        unsigned long remoteTasks;
+    };
+
+    const WorkerState& worker(std::size_t index) const {
+        return *workers_[index];
+    }
+
+    /**
+     * Nodes with at least one CPU allowed for this process, a single node
+     * with every allowed CPU when sysfs cannot be read.
+     */
+    static void discover(const char* root, std::vector<int>* pIds,
+                         std::vector<cpu_set_t>* pCpus) {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        ::sched_getaffinity(0, sizeof(allowed), &allowed);
+        std::string path(root);
+        std::string value;
+        cpu_set_t online;
+        if (readFile(path + "/online", &value) &&
+            Topology::parse_cpu_list(value.c_str(), &online)) {
+            for (int id = 0; id < CPU_SETSIZE; ++id) {
+                char name[32];
+                std::sprintf(name, "/node%d/cpulist", id);
+                cpu_set_t cpus;
+                if (!CPU_ISSET(id, &online) ||
+                    !readFile(path + name, &value) ||
+                    !Topology::parse_cpu_list(value.c_str(), &cpus)) {
+                    continue;
+                }
+                CPU_AND(&cpus, &cpus, &allowed);
+                if (CPU_COUNT(&cpus) > 0) {
+                    pIds->push_back(id);
+                    pCpus->push_back(cpus);
+                }
+            }
+        }
+        if (pIds->empty()) {
+            pIds->push_back(0);
+            pCpus->push_back(allowed);
+        }
+    }
+
+    static bool readFile(const std::string& path, std::string* pValue) {
+        std::FILE* pFile = std::fopen(path.c_str(), "r");
+        if (pFile == NULL) {
+            return false;
+        }
+        char buffer[4096];
+        bool isRead = std::fgets(buffer, sizeof(buffer), pFile) != NULL;
+        std::fclose(pFile);
+        if (isRead) {
+            pValue->assign(buffer);
+        }
+        return isRead;
+    }
+
+    /**
+     * Index of the node running the calling thread.
+     */
+    std::size_t callerNode() const {
+        Worker* pWorker = static_cast<Worker*>(callerWorker());
+        if (pWorker != NULL) {
+            return pWorker->node;
+        }
+        int cpu = ::sched_getcpu();
+        for (std::size_t i = 0; cpu >= 0 && i < nodeCount_; ++i) {
+            if (CPU_ISSET(cpu, &nodes_[i].cpus)) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    void push(const Task& task) {
+        pushNode(callerNode(), task);
+    }
+
+    void pushNode(std::size_t index, const Task& task) {
+        Node& node = nodes_[index];
+        addPending();
+        ::pthread_mutex_lock(&node.mutex);
+        try {
+            node.tasks.push_back(task);
+        }
+        catch (...) {
+            ::pthread_mutex_unlock(&node.mutex);
+            removePending();
+            Task(task).destroy();
+            throw;
+        }
+        __atomic_store_n(&node.size, node.tasks.size(), __ATOMIC_RELAXED);
+        __atomic_add_fetch(&queued_, 1, __ATOMIC_RELAXED);
+        ::pthread_mutex_unlock(&node.mutex);
+        // a worker of the node first
+        wake(sleepers_, nodeCount_, index);
+    }
+
+    bool popNode(std::size_t index, Task& task) {
+        Node& node = nodes_[index];
+        if (__atomic_load_n(&node.size, __ATOMIC_RELAXED) == 0) {
+            return false;
+        }
+        bool isFound = false;
+        ::pthread_mutex_lock(&node.mutex);
+        if (!node.tasks.empty()) {
+            task = node.tasks.front();
+            node.tasks.pop_front();
+            __atomic_store_n(&node.size, node.tasks.size(), __ATOMIC_RELAXED);
+            __atomic_sub_fetch(&queued_, 1, __ATOMIC_RELAXED);
+            isFound = true;
+        }
+        ::pthread_mutex_unlock(&node.mutex);
+        return isFound;
+    }
+
+    bool findTask(Worker* pWorker, Task& task) {
+        if (popNode(pWorker->node, task)) {
+            increment(pWorker->localTasks);
+            return true;
+        }
+        for (std::size_t i = 1; i < nodeCount_; ++i) {
+            if (popNode((pWorker->node + i) % nodeCount_, task)) {
+                increment(pWorker->remoteTasks);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool hasTask() const {
+        return __atomic_load_n(&queued_, __ATOMIC_RELAXED) != 0;
+    }
+
+    void run(Worker* pWorker) {
+        runWorker(pWorker, sleepers_[pWorker->node]);
+    }
+
+    // also after a failed allocation of the constructor
+    void stop() {
+        if (sleepers_ != NULL) {
+            stopWorkers(sleepers_, nodeCount_);
+        }
+        // join the workers
+        delete[] threads_;
+        for (std::size_t i = 0; workers_ != NULL && i < size_; ++i) {
+            if (workers_[i] != NULL) {
+                workers_[i]->~Worker();
+                deallocate_on_node(workers_[i], sizeof(Worker));
+            }
+        }
+        delete[] workers_;
+        delete[] sleepers_;
+        delete[] nodes_;
+    }
+
+    Node* nodes_;
+    std::size_t nodeCount_;
+    Thread* threads_;
+    Worker** workers_;
+    std::size_t size_;
+    // calls waiting in the queues of every node
+    std::size_t queued_;
+    // workers of each node parked in sleep
+    Sleepers* sleepers_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_NUMA_POOL_H_
@@ -0,0 +1,194 @@
+/**
+ * rw_lock.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_RW_LOCK_H_
+#define BLET_RW_LOCK_H_
+
+#include <unistd.h>
+
+#include <cstddef>
+
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Reader-writer lock for read-mostly data.
+ * Each reader counts itself in its own cache line padded slot, picked once
+ * per thread, so readers on different slots never write the same line.
+ * A writer raises a flag then waits for every slot to drain, readers that
+ * see the flag step back and wait for the writer to finish.
+ * Writers are cheap to block but expensive to run: they scan all the slots.
+ */
+class RwLock {
+  public:
+    /**
+     * 0 slots means one per configured CPU.
+     */
+    explicit RwLock(std::size_t slotCount = 0) :
+        slots_(NULL),
+        slotCount_(slotCount),
+        writer_(0) {
+        if (slotCount_ == 0) {
+            long cpuCount = ::sysconf(_SC_NPROCESSORS_CONF);
+            slotCount_ = cpuCount > 0 ? static_cast<std::size_t>(cpuCount) : 1;
+        }
+        slots_ = new Slot[slotCount_];
+        for (std::size_t i = 0; i < slotCount_; ++i) {
+            slots_[i].readers = 0;
+        }
+    }
+
+    ~RwLock() {
+        delete[] slots_;
+    }
+
+    std::size_t slot_count() const {
+        return slotCount_;
+    }
+
+    void lock_shared() {
+        Slot& slot = slots_[threadSlot() % slotCount_];
+        while (!tryEnter(slot)) {
+            while (__atomic_load_n(&writer_, __ATOMIC_ACQUIRE) != 0) {
+                Thread::futexWait(&writer_, 1);
+            }
+        }
+    }
+
+    bool try_lock_shared() {
+        return tryEnter(slots_[threadSlot() % slotCount_]);
+    }
+
+    void unlock_shared() {
+        leave(slots_[threadSlot() % slotCount_]);
+    }
+
+    void lock() {
+        writerMutex_.lock();
+        __atomic_store_n(&writer_, 1, __ATOMIC_SEQ_CST);
+        for (std::size_t i = 0; i < slotCount_; ++i) {
+            int readers = __atomic_load_n(&slots_[i].readers, __ATOMIC_SEQ_CST);
+            while (readers != 0) {
+                Thread::futexWait(&slots_[i].readers, readers);
+                readers = __atomic_load_n(&slots_[i].readers, __ATOMIC_SEQ_CST);
+            }
+        }
+    }
+
+    bool try_lock() {
+        if (!writerMutex_.try_lock()) {
+            return false;
+        }
+        __atomic_store_n(&writer_, 1, __ATOMIC_SEQ_CST);
+        for (std::size_t i = 0; i < slotCount_; ++i) {
+            if (__atomic_load_n(&slots_[i].readers, __ATOMIC_SEQ_CST) != 0) {
+                unlock();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() {
+        __atomic_store_n(&writer_, 0, __ATOMIC_RELEASE);
+        Thread::futexWake(&writer_);
+        writerMutex_.unlock();
+    }
+
+  private:
+    RwLock(const RwLock&);
+    RwLock& operator=(const RwLock&);
+
+    struct Slot {
+        int readers;
+        char padding[64 - sizeof(int)];
+    };
+
+    bool tryEnter(Slot& slot) {
+        // ordered with the store of writer_ in lock, one of the two sides
+        // sees the other
+        __atomic_add_fetch(&slot.readers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&writer_, __ATOMIC_SEQ_CST) == 0) {
+            return true;
+        }
+        leave(slot);
+        return false;
+    }
+
+    void leave(Slot& slot) {
+        if (__atomic_sub_fetch(&slot.readers, 1, __ATOMIC_SEQ_CST) == 0 &&
+            __atomic_load_n(&writer_, __ATOMIC_SEQ_CST) != 0) {
+            // the writer may wait for this slot
+            Thread::futexWake(&slot.readers);
+        }
+    }
+
+    // assigned round robin on the first shared lock of the thread
+    static std::size_t threadSlot() {
+        static __thread std::size_t slot = 0;
+        static __thread bool isAssigned = false;
+        if (!isAssigned) {
+            static std::size_t nextSlot = 0;
+            slot = __atomic_fetch_add(&nextSlot, 1, __ATOMIC_RELAXED);
+            isAssigned = true;
+        }
+        return slot;
+    }
+
+    Slot* slots_;
+    std::size_t slotCount_;
+    char paddingWriter_[64];
+    int writer_;
+    Mutex writerMutex_;
+};
+
+/**
+ * Scoped shared lock for any type with lock_shared and unlock_shared.
+ */
+template<typename M>
+class SharedLockGuard {
+  public:
+    explicit SharedLockGuard(M& mutex) :
+        mutex_(mutex) {
+        mutex_.lock_shared();
+    }
+
+    ~SharedLockGuard() {
+        mutex_.unlock_shared();
+    }
+
+  private:
+    SharedLockGuard(const SharedLockGuard&);
+    SharedLockGuard& operator=(const SharedLockGuard&);
+
+    M& mutex_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_RW_LOCK_H_
@@ -0,0 +1,125 @@
+/**
+ * seq_lock.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_SEQ_LOCK_H_
+#define BLET_SEQ_LOCK_H_
+
+#include <cstddef>
+
+#include "blet/mutex.h"
+
+namespace blet {
+
+/**
+ * Snapshot of a trivially copyable T with a single writer.
+ * The writer makes the sequence odd, copies the value then makes it even
+ * again, a reader copies the value between two reads of the sequence and
+ * retries when they differ or are odd.
+ * Readers only load, they never invalidate the cache line of each other.
+ * The value is copied word by word with relaxed atomic accesses, a torn copy
+ * is detected by the sequence and never returned.
+ */
+template<typename T>
+class SeqLock {
+  public:
+    SeqLock() :
+        sequence_(0) {
+        storage_.value = T();
+    }
+
+    explicit SeqLock(const T& value) :
+        sequence_(0) {
+        storage_.value = value;
+    }
+
+    T load() const {
+        Storage storage;
+        for (;;) {
+            unsigned int sequence =
+                __atomic_load_n(&sequence_, __ATOMIC_ACQUIRE);
+            if ((sequence & 1) != 0) {
+                // store in progress
+                cpu_relax();
+                continue;
+            }
+            for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+                storage.words[i] =
+                    __atomic_load_n(&storage_.words[i], __ATOMIC_RELAXED);
+            }
+            // the copy happens before the second read of the sequence
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&sequence_, __ATOMIC_RELAXED) == sequence) {
+                return storage.value;
+            }
+        }
+    }
+
+    /**
+     * Only one thread at a time may store.
+     */
+    void store(const T& value) {
+        Storage storage;
+        storage.value = value;
+        unsigned int sequence = __atomic_load_n(&sequence_, __ATOMIC_RELAXED);
+        __atomic_store_n(&sequence_, sequence + 1, __ATOMIC_RELAXED);
+        // the odd sequence is visible before any word of the copy
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            __atomic_store_n(&storage_.words[i], storage.words[i],
+                             __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&sequence_, sequence + 2, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Number of stores so far.
+     */
+    unsigned int version() const {
+        return __atomic_load_n(&sequence_, __ATOMIC_ACQUIRE) / 2;
+    }
+
+  private:
+    SeqLock(const SeqLock&);
+    SeqLock& operator=(const SeqLock&);
+
+    enum {
+        WORD_COUNT = (sizeof(T) + sizeof(unsigned long) - 1) /
+                     sizeof(unsigned long)
+    };
+
+    // a union member must be trivially copyable
+    union Storage {
+        T value;
+        unsigned long words[WORD_COUNT];
+    };
+
+    unsigned int sequence_;
+    Storage storage_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_SEQ_LOCK_H_
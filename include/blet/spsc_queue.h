@@ -0,0 +1,190 @@
+/**
+ * spsc_queue.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_SPSC_QUEUE_H_
+#define BLET_SPSC_QUEUE_H_
+
+#include <cstddef>
+
+namespace blet {
+
+/**
+ * Bounded single-producer single-consumer ring.
+ * Exactly one thread pushes and exactly one thread pops, every call completes
+ * in a bounded number of steps.
+ * Each side keeps a private copy of the opposite index and only reloads it
+ * when the copy says the ring is full (or empty), so the cache line of the
+ * other side is not touched on most calls.
+ * The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class SpscQueue {
+  public:
+    explicit SpscQueue(std::size_t capacity) :
+        values_(NULL),
+        mask_(0),
+        tail_(0),
+        cachedHead_(0),
+        head_(0),
+        cachedTail_(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        values_ = new T[size];
+    }
+
+    ~SpscQueue() {
+        delete[] values_;
+    }
+
+    std::size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * Exact from the producer or the consumer, approximate from another
+     * thread.
+     */
+    std::size_t size() const {
+        std::size_t head = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+        std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+        return tail - head;
+    }
+
+    /**
+     * Producer only, return false when the ring is full.
+     */
+    bool try_push(const T& value) {
+        std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+            if (tail - cachedHead_ > mask_) {
+                return false;
+            }
+        }
+        values_[tail & mask_] = value;
+        __atomic_store_n(&tail_, tail + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * Producer only, push up to count values and return how many were
+     * pushed.
+     * The values are published with a single index update.
+     */
+    std::size_t push_n(const T* values, std::size_t count) {
+        std::size_t tail = __atomic_load_n(&tail_, __ATOMIC_RELAXED);
+        std::size_t freeCount = mask_ + 1 - (tail - cachedHead_);
+        if (freeCount < count) {
+            cachedHead_ = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+            freeCount = mask_ + 1 - (tail - cachedHead_);
+            if (count > freeCount) {
+                count = freeCount;
+            }
+        }
+        // at most two contiguous spans: up to the end of the ring, then from
+        // its start
+        std::size_t offset = tail & mask_;
+        std::size_t first = mask_ + 1 - offset;
+        if (first > count) {
+            first = count;
+        }
+        copy(values, first, values_ + offset);
+        copy(values + first, count - first, values_);
+        __atomic_store_n(&tail_, tail + count, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    /**
+     * Consumer only, return false when the ring is empty.
+     */
+    bool try_pop(T& value) {
+        std::size_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        if (head == cachedTail_) {
+            cachedTail_ = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        value = values_[head & mask_];
+        __atomic_store_n(&head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * Consumer only, pop up to count values and return how many were popped.
+     * The cells are released with a single index update.
+     */
+    std::size_t pop_n(T* values, std::size_t count) {
+        std::size_t head = __atomic_load_n(&head_, __ATOMIC_RELAXED);
+        std::size_t usedCount = cachedTail_ - head;
+        if (usedCount < count) {
+            cachedTail_ = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+            usedCount = cachedTail_ - head;
+            if (count > usedCount) {
+                count = usedCount;
+            }
+        }
+        std::size_t offset = head & mask_;
+        std::size_t first = mask_ + 1 - offset;
+        if (first > count) {
+            first = count;
+        }
+        copy(values_ + offset, first, values);
+        copy(values_, count - first, values + first);
+        __atomic_store_n(&head_, head + count, __ATOMIC_RELEASE);
+        return count;
+    }
+
+  private:
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+
+    static void copy(const T* pSource, std::size_t count, T* pDestination) {
+        for (std::size_t i = 0; i < count; ++i) {
+            pDestination[i] = pSource[i];
+        }
+    }
+
+    // read-only after construction
+    char paddingValues_[64];
+    T* values_;
+    std::size_t mask_;
+    char paddingTail_[64 - sizeof(T*) - sizeof(std::size_t)];
+    // written by the producer
+    std::size_t tail_;
+    std::size_t cachedHead_;
+    char paddingHead_[64 - 2 * sizeof(std::size_t)];
+    // written by the consumer
+    std::size_t head_;
+    std::size_t cachedTail_;
+    char paddingEnd_[64 - 2 * sizeof(std::size_t)];
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_SPSC_QUEUE_H_
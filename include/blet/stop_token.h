@@ -0,0 +1,372 @@
+/**
+ * stop_token.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_STOP_TOKEN_H_
+#define BLET_STOP_TOKEN_H_
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+class StopCallback;
+
+/**
+ * State shared by a StopSource, its StopTokens and StopCallbacks.
+ * The last of them to release it deletes it.
+ */
+struct StopState {
+    enum Status {
+        STOP_NONE,
+        // not requested with at least one thread blocked in wait
+        STOP_WAITED,
+        STOP_REQUESTED
+    };
+
+    StopState() :
+        refCount(1),
+        status(STOP_NONE),
+        pCallbacks(NULL),
+        pRunning(NULL),
+        runner(),
+        runCount(0) {
+        ::pthread_mutex_init(&mutex, NULL);
+    }
+
+    ~StopState() {
+        ::pthread_mutex_destroy(&mutex);
+    }
+
+    static StopState* acquire(StopState* pState) {
+        if (pState != NULL) {
+            __atomic_add_fetch(&pState->refCount, 1, __ATOMIC_RELAXED);
+        }
+        return pState;
+    }
+
+    static void release(StopState* pState) {
+        if (pState != NULL &&
+            __atomic_sub_fetch(&pState->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+            delete pState;
+        }
+    }
+
+    bool is_requested() const {
+        return __atomic_load_n(&status, __ATOMIC_RELAXED) == STOP_REQUESTED;
+    }
+
+    /**
+     * Announce a waiter, false when the stop is already requested.
+     */
+    bool prepareWait() {
+        int expected = STOP_NONE;
+        __atomic_compare_exchange_n(&status, &expected, STOP_WAITED, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+        return __atomic_load_n(&status, __ATOMIC_ACQUIRE) != STOP_REQUESTED;
+    }
+
+    void wait() {
+        while (prepareWait()) {
+            Thread::futexWait(&status, STOP_WAITED);
+        }
+    }
+
+#ifdef __linux__
+    bool waitFor(long milliseconds) {
+        struct timespec timeout;
+        timeout.tv_sec = milliseconds / 1000;
+        timeout.tv_nsec = milliseconds % 1000 * 1000000L;
+        struct timespec deadline =
+            Thread::clockDeadline(CLOCK_MONOTONIC, timeout);
+        while (prepareWait()) {
+            struct timespec remaining;
+            if (!Thread::remainingTime(deadline, &remaining)) {
+                return false;
+            }
+            Thread::futexWait(&status, STOP_WAITED, &remaining);
+        }
+        return true;
+    }
+#endif
+
+    /**
+     * True for the call that made the request.
+     */
+    bool request() {
+        int previous =
+            __atomic_exchange_n(&status, STOP_REQUESTED, __ATOMIC_ACQ_REL);
+        if (previous == STOP_WAITED) {
+            // only enter the kernel when somebody is waiting
+            Thread::futexWake(&status);
+        }
+        return previous != STOP_REQUESTED;
+    }
+
+    // the mutex is locked before and after
+    void waitRun() {
+        int count = runCount;
+        ::pthread_mutex_unlock(&mutex);
+        Thread::futexWait(&runCount, count);
+        ::pthread_mutex_lock(&mutex);
+    }
+
+    void endRun() {
+        pRunning = NULL;
+        ++runCount;
+        Thread::futexWake(&runCount);
+    }
+
+    int refCount;
+    int status;
+    // registered callbacks, the one being run by request_stop and its thread
+    ::pthread_mutex_t mutex;
+    StopCallback* pCallbacks;
+    StopCallback* pRunning;
+    ::pthread_t runner;
+    // futex word bumped after each callback run by request_stop
+    int runCount;
+};
+
+/**
+ * Copyable view of a StopSource given to the thread that must stop, passed
+ * by value like any other argument of start or submit.
+ * stop_requested is a single relaxed load, cheap enough for hot loops.
+ */
+class StopToken {
+  public:
+    /**
+     * Without StopSource, a stop can never be requested.
+     */
+    StopToken() :
+        pState_(NULL) {}
+
+    StopToken(const StopToken& rhs) :
+        pState_(StopState::acquire(rhs.pState_)) {}
+
+    StopToken& operator=(const StopToken& rhs) {
+        StopState* pState = StopState::acquire(rhs.pState_);
+        StopState::release(pState_);
+        pState_ = pState;
+        return *this;
+    }
+
+    ~StopToken() {
+        StopState::release(pState_);
+    }
+
+    bool stop_requested() const {
+        return pState_ != NULL && pState_->is_requested();
+    }
+
+    bool stop_possible() const {
+        return pState_ != NULL;
+    }
+
+    /**
+     * Block on the futex word until a stop is requested.
+     * Never returns without StopSource.
+     */
+    void wait() const {
+        if (pState_ == NULL) {
+            for (;;) {
+                ::pause();
+            }
+        }
+        pState_->wait();
+    }
+
+#ifdef __linux__
+    /**
+     * Return false when no stop was requested within milliseconds.
+     */
+    bool wait_for(long milliseconds) const {
+        if (pState_ == NULL) {
+            struct timespec timeout;
+            timeout.tv_sec = milliseconds / 1000;
+            timeout.tv_nsec = milliseconds % 1000 * 1000000L;
+            ::nanosleep(&timeout, NULL);
+            return false;
+        }
+        return pState_->waitFor(milliseconds);
+    }
+#endif
+
+  private:
+    friend class StopSource;
+    friend class StopCallback;
+
+    explicit StopToken(StopState* pState) :
+        pState_(StopState::acquire(pState)) {}
+
+    StopState* pState_;
+};
+
+/**
+ * Call pFunction(data) once a stop is requested, in the thread calling
+ * request_stop, or at once in the constructor when it already was.
+ * The destructor unregisters the call, waiting for it when another thread
+ * is running it.
+ * pFunction must not throw.
+ */
+class StopCallback {
+  public:
+    StopCallback(const StopToken& token, void (*pFunction)(void*),
+                 void* data) :
+        pState_(StopState::acquire(token.pState_)),
+        pFunction_(pFunction),
+        data_(data),
+        pPrev_(NULL),
+        pNext_(NULL) {
+        if (pState_ == NULL) {
+            return;
+        }
+        ::pthread_mutex_lock(&pState_->mutex);
+        if (pState_->is_requested()) {
+            ::pthread_mutex_unlock(&pState_->mutex);
+            pFunction_(data_);
+            return;
+        }
+        pNext_ = pState_->pCallbacks;
+        if (pNext_ != NULL) {
+            pNext_->pPrev_ = this;
+        }
+        pState_->pCallbacks = this;
+        ::pthread_mutex_unlock(&pState_->mutex);
+    }
+
+    ~StopCallback() {
+        if (pState_ == NULL) {
+            return;
+        }
+        ::pthread_mutex_lock(&pState_->mutex);
+        if (pState_->pCallbacks == this || pPrev_ != NULL) {
+            unlink();
+        }
+        while (pState_->pRunning == this &&
+               !::pthread_equal(pState_->runner, ::pthread_self())) {
+            pState_->waitRun();
+        }
+        ::pthread_mutex_unlock(&pState_->mutex);
+        StopState::release(pState_);
+    }
+
+  private:
+    friend class StopSource;
+
+    StopCallback(const StopCallback&);
+    StopCallback& operator=(const StopCallback&);
+
+    // called with the mutex of the state locked
+    void unlink() {
+        if (pPrev_ != NULL) {
+            pPrev_->pNext_ = pNext_;
+        }
+        else {
+            pState_->pCallbacks = pNext_;
+        }
+        if (pNext_ != NULL) {
+            pNext_->pPrev_ = pPrev_;
+        }
+        pPrev_ = NULL;
+        pNext_ = NULL;
+    }
+
+    StopState* pState_;
+    void (*pFunction_)(void*);
+    void* data_;
+    StopCallback* pPrev_;
+    StopCallback* pNext_;
+};
+
+/**
+ * Cooperative replacement of Thread::cancel: the stopping thread polls its
+ * StopToken or blocks in StopToken::wait, nothing is unwound asynchronously.
+ * Copies share the same state.
+ */
+class StopSource {
+  public:
+    StopSource() :
+        pState_(new StopState()) {}
+
+    StopSource(const StopSource& rhs) :
+        pState_(StopState::acquire(rhs.pState_)) {}
+
+    StopSource& operator=(const StopSource& rhs) {
+        StopState* pState = StopState::acquire(rhs.pState_);
+        StopState::release(pState_);
+        pState_ = pState;
+        return *this;
+    }
+
+    ~StopSource() {
+        StopState::release(pState_);
+    }
+
+    StopToken get_token() const {
+        return StopToken(pState_);
+    }
+
+    bool stop_requested() const {
+        return pState_->is_requested();
+    }
+
+    /**
+     * Wake the threads blocked in StopToken::wait and run the registered
+     * callbacks in this thread.
+     * Return false when a stop was already requested.
+     */
+    bool request_stop() {
+        if (!pState_->request()) {
+            return false;
+        }
+        ::pthread_mutex_lock(&pState_->mutex);
+        while (pState_->pCallbacks != NULL) {
+            StopCallback* pCallback = pState_->pCallbacks;
+            pCallback->unlink();
+            pState_->pRunning = pCallback;
+            pState_->runner = ::pthread_self();
+            ::pthread_mutex_unlock(&pState_->mutex);
+            // may destroy pCallback from this thread
+            pCallback->pFunction_(pCallback->data_);
+            ::pthread_mutex_lock(&pState_->mutex);
+            pState_->endRun();
+        }
+        ::pthread_mutex_unlock(&pState_->mutex);
+        return true;
+    }
+
+  private:
+    StopState* pState_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_STOP_TOKEN_H_
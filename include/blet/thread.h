@@ -31,16 +31,692 @@
 #define BLET_THREAD_H_
 
 #include <pthread.h>
-
+#include <sched.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
 #include <exception>
+#include <new>
+#ifdef __GLIBCXX__
+#include <cxxabi.h>
+#endif
+
+/**
+ * Bound calls (function, object and copied arguments) up to this size are
+ * copied by the new thread from the caller instead of going through the heap,
+ * persistent workers store them inside the Thread object.
+ */
+#ifndef BLET_THREAD_INLINE_SIZE
+#define BLET_THREAD_INLINE_SIZE 128
+#endif
+
+/**
+ * Recycle the heap allocated bound calls through process-wide lock-free free
+ * lists instead of returning them to malloc.
+ */
+#ifndef BLET_THREAD_DATA_POOL
+#define BLET_THREAD_DATA_POOL 1
+#endif
+
+/**
+ * Maximum number of thread stacks kept mapped by the StackCache.
+ */
+#ifndef BLET_THREAD_STACK_CACHE_SIZE
+#define BLET_THREAD_STACK_CACHE_SIZE 16
+#endif
+
+/**
+ * join_for waits with pthread_clockjoin_np (glibc 2.31) on CLOCK_MONOTONIC,
+ * on a futex word set when the thread function returns otherwise.
+ */
+#ifndef BLET_THREAD_CLOCKJOIN
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 31))
+#define BLET_THREAD_CLOCKJOIN 1
+#else
+#define BLET_THREAD_CLOCKJOIN 0
+#endif
+#endif
 
 namespace blet {
 
+/**
+ * Size-classed pool of memory blocks shared by every thread of the process.
+ * Each size class (64 bytes to 4 KiB) is a Treiber stack whose head carries a
+ * modification tag to protect pop against ABA.
+ * Pooled blocks are never given back to the system, bigger blocks go to the
+ * heap.
+ * A thread can put a LocalCache in front of the shared free lists, see
+ * set_local_cache.
+ */
+class ThreadDataPool {
+  private:
+    enum {
+        MIN_BLOCK_SHIFT = 6,
+        SIZE_CLASS_COUNT = 7,
+        // blocks kept by a LocalCache per size class
+        LOCAL_CACHE_SIZE = 64
+    };
+
+    struct Block {
+        Block* pNext;
+    };
+
+  public:
+    struct Stats {
+        unsigned long hits;
+        unsigned long misses;
+    };
+
+    /**
+     * Free lists owned by a single thread, no atomic operation.
+     */
+    class LocalCache {
+      public:
+        LocalCache() {
+            for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+                pHeads_[i] = NULL;
+                counts_[i] = 0;
+                hits_[i] = 0;
+            }
+        }
+
+      private:
+        friend class ThreadDataPool;
+
+        LocalCache(const LocalCache&);
+        LocalCache& operator=(const LocalCache&);
+
+        void* pop(std::size_t index) {
+            Block* pBlock = pHeads_[index];
+            pHeads_[index] = pBlock->pNext;
+            --counts_[index];
+            ++hits_[index];
+            return pBlock;
+        }
+
+        void push(std::size_t index, Block* pBlock) {
+            pBlock->pNext = pHeads_[index];
+            pHeads_[index] = pBlock;
+            ++counts_[index];
+        }
+
+        // give the blocks and the hits back to the shared free lists
+        void flush() {
+            for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+                FreeList& freeList = freeLists()[i];
+                while (pHeads_[i] != NULL) {
+                    Block* pBlock = pHeads_[i];
+                    pHeads_[i] = pBlock->pNext;
+                    ThreadDataPool::push(freeList, pBlock);
+                }
+                counts_[i] = 0;
+                __atomic_fetch_add(&freeList.hits, hits_[i], __ATOMIC_RELAXED);
+                hits_[i] = 0;
+            }
+        }
+
+        Block* pHeads_[SIZE_CLASS_COUNT];
+        std::size_t counts_[SIZE_CLASS_COUNT];
+        unsigned long hits_[SIZE_CLASS_COUNT];
+    };
+
+    static void* allocate(std::size_t size) {
+        std::size_t index = sizeClass(size);
+        FreeList& freeList = freeLists()[index];
+#if BLET_THREAD_DATA_POOL
+        if (index < SIZE_CLASS_COUNT) {
+            LocalCache* pCache = localCache();
+            if (pCache != NULL && pCache->pHeads_[index] != NULL) {
+                return pCache->pop(index);
+            }
+            void* pBlock = pop(freeList);
+            if (pBlock != NULL) {
+                __atomic_fetch_add(&freeList.hits, 1, __ATOMIC_RELAXED);
+                return pBlock;
+            }
+            __atomic_fetch_add(&freeList.misses, 1, __ATOMIC_RELAXED);
+            return newBlock(freeList, index);
+        }
+#endif
+        __atomic_fetch_add(&freeList.misses, 1, __ATOMIC_RELAXED);
+        return ::operator new(size);
+    }
+
+    static void deallocate(void* pBlock, std::size_t size) {
+#if BLET_THREAD_DATA_POOL
+        std::size_t index = sizeClass(size);
+        if (index < SIZE_CLASS_COUNT) {
+            LocalCache* pCache = localCache();
+            if (pCache != NULL && pCache->counts_[index] < LOCAL_CACHE_SIZE) {
+                pCache->push(index, reinterpret_cast<Block*>(pBlock));
+            }
+            else {
+                push(freeLists()[index], reinterpret_cast<Block*>(pBlock));
+            }
+            return;
+        }
+#else
+        (void)size;
+#endif
+        ::operator delete(pBlock);
+    }
+
+    template<typename T>
+    static T* create(const T& value) {
+        void* pBlock = allocate(sizeof(T));
+        try {
+            return new (pBlock) T(value);
+        }
+        catch (...) {
+            deallocate(pBlock, sizeof(T));
+            throw;
+        }
+    }
+
+    /**
+     * Construct T(a1, a2) in place.
+     */
+    template<typename T, typename A1, typename A2>
+    static T* create(const A1& a1, const A2& a2) {
+        void* pBlock = allocate(sizeof(T));
+        try {
+            return new (pBlock) T(a1, a2);
+        }
+        catch (...) {
+            deallocate(pBlock, sizeof(T));
+            throw;
+        }
+    }
+
+    template<typename T>
+    static void destroy(T* pValue) {
+        pValue->~T();
+        deallocate(pValue, sizeof(T));
+    }
+
+    /**
+     * Serve the allocations of the calling thread from pCache before the
+     * shared free lists, NULL to stop.
+     * The blocks and hits of the previous cache of the thread go back to the
+     * shared free lists and stats.
+     */
+    static void set_local_cache(LocalCache* pCache) {
+        LocalCache* pPrevious = localCache();
+        if (pPrevious != NULL) {
+            pPrevious->flush();
+        }
+        localCache() = pCache;
+    }
+
+    /**
+     * The hits of the caches still set on a thread are not counted yet.
+     */
+    static Stats stats() {
+        Stats result;
+        result.hits = 0;
+        result.misses = 0;
+        for (std::size_t i = 0; i <= SIZE_CLASS_COUNT; ++i) {
+            FreeList& freeList = freeLists()[i];
+            result.hits += __atomic_load_n(&freeList.hits, __ATOMIC_RELAXED);
+            result.misses +=
+                __atomic_load_n(&freeList.misses, __ATOMIC_RELAXED);
+        }
+        return result;
+    }
+
+  private:
+    // head of a free list: block address in the low bits, tag in the high bits
+    typedef uint64_t TaggedPointer;
+
+    // prefix of every pooled block, keeps the cache reachable for leak checkers
+    union Header {
+        Header* pNext;
+        long double align;
+    };
+
+    struct FreeList {
+        TaggedPointer head;
+        Header* pAllocated;
+        unsigned long hits;
+        unsigned long misses;
+    } __attribute__((aligned(64)));
+
+    static LocalCache*& localCache() {
+        static __thread LocalCache* pCache = NULL;
+        return pCache;
+    }
+
+    static FreeList* freeLists() {
+        // the last entry only counts the blocks too big for the pool
+        static FreeList freeLists[SIZE_CLASS_COUNT + 1];
+        return freeLists;
+    }
+
+    static std::size_t sizeClass(std::size_t size) {
+        std::size_t index = 0;
+        while (index < SIZE_CLASS_COUNT &&
+               (static_cast<std::size_t>(1) << (MIN_BLOCK_SHIFT + index)) <
+                   size) {
+            ++index;
+        }
+        return index;
+    }
+
+    static void* newBlock(FreeList& freeList, std::size_t index) {
+        std::size_t size = static_cast<std::size_t>(1)
+                           << (MIN_BLOCK_SHIFT + index);
+        Header* pHeader =
+            reinterpret_cast<Header*>(::operator new(sizeof(Header) + size));
+        pHeader->pNext =
+            __atomic_load_n(&freeList.pAllocated, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&freeList.pAllocated,
+                                            &pHeader->pNext, pHeader, true,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+        }
+        return pHeader + 1;
+    }
+
+    static unsigned int tagShift() {
+        return sizeof(void*) == 8 ? 48 : 32;
+    }
+
+    static Block* pointer(TaggedPointer head) {
+        TaggedPointer mask = (static_cast<TaggedPointer>(1) << tagShift()) - 1;
+        return reinterpret_cast<Block*>(static_cast<std::size_t>(head & mask));
+    }
+
+    static TaggedPointer tagged(Block* pBlock, TaggedPointer previous) {
+        TaggedPointer tag = (previous >> tagShift()) + 1;
+        TaggedPointer address = reinterpret_cast<std::size_t>(pBlock);
+        return (tag << tagShift()) | address;
+    }
+
+    static void push(FreeList& freeList, Block* pBlock) {
+        TaggedPointer head = __atomic_load_n(&freeList.head, __ATOMIC_RELAXED);
+        do {
+            // a stale pop may still be reading pNext of this block
+            __atomic_store_n(&pBlock->pNext, pointer(head), __ATOMIC_RELAXED);
+        } while (!__atomic_compare_exchange_n(&freeList.head, &head,
+                                              tagged(pBlock, head), true,
+                                              __ATOMIC_RELEASE,
+                                              __ATOMIC_RELAXED));
+    }
+
+    static void* pop(FreeList& freeList) {
+        TaggedPointer head = __atomic_load_n(&freeList.head, __ATOMIC_ACQUIRE);
+        while (pointer(head) != NULL) {
+            // the block may already be reused, the tag rejects a stale next
+            Block* pNext =
+                __atomic_load_n(&pointer(head)->pNext, __ATOMIC_RELAXED);
+            if (__atomic_compare_exchange_n(&freeList.head, &head,
+                                            tagged(pNext, head), true,
+                                            __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE)) {
+                return pointer(head);
+            }
+        }
+        return NULL;
+    }
+};
+
+/**
+ * Process-wide cache of thread stacks mapped with mmap, each one above a
+ * PROT_NONE guard area.
+ * A stack comes back when its thread has been joined and is handed to the
+ * next thread asking for the same sizes, up to BLET_THREAD_STACK_CACHE_SIZE
+ * stacks, the others are unmapped.
+ */
+class StackCache {
+  public:
+    struct Stats {
+        unsigned long hits;
+        unsigned long misses;
+    };
+
+    /**
+     * Return the lowest address of stackSize usable bytes, NULL when the
+     * mapping fails.
+     * Both sizes must be multiples of the page size.
+     */
+    static void* allocate(std::size_t stackSize, std::size_t guardSize) {
+        State& state = getState();
+        ::pthread_mutex_lock(&state.mutex);
+        Node** ppNode = &state.pHead;
+        while (*ppNode != NULL && ((*ppNode)->stackSize != stackSize ||
+                                   (*ppNode)->guardSize != guardSize)) {
+            ppNode = &(*ppNode)->pNext;
+        }
+        Node* pNode = *ppNode;
+        if (pNode != NULL) {
+            *ppNode = pNode->pNext;
+            --state.size;
+            ++state.stats.hits;
+        }
+        else {
+            ++state.stats.misses;
+        }
+        ::pthread_mutex_unlock(&state.mutex);
+        if (pNode != NULL) {
+            return pNode;
+        }
+        char* pMap = static_cast<char*>(::mmap(NULL, guardSize + stackSize,
+                                               PROT_READ | PROT_WRITE,
+                                               MAP_PRIVATE | MAP_ANONYMOUS
+#ifdef MAP_STACK
+                                                   | MAP_STACK
+#endif
+                                               ,
+                                               -1, 0));
+        if (pMap == MAP_FAILED) {
+            return NULL;
+        }
+        if (guardSize > 0) {
+            ::mprotect(pMap, guardSize, PROT_NONE);
+        }
+        return pMap + guardSize;
+    }
+
+    /**
+     * The thread running on pStack must be joined.
+     */
+    static void deallocate(void* pStack, std::size_t stackSize,
+                           std::size_t guardSize) {
+        State& state = getState();
+        ::pthread_mutex_lock(&state.mutex);
+        if (state.size < BLET_THREAD_STACK_CACHE_SIZE) {
+            Node* pNode = static_cast<Node*>(pStack);
+            pNode->pNext = state.pHead;
+            pNode->stackSize = stackSize;
+            pNode->guardSize = guardSize;
+            state.pHead = pNode;
+            ++state.size;
+            pStack = NULL;
+        }
+        ::pthread_mutex_unlock(&state.mutex);
+        if (pStack != NULL) {
+            ::munmap(static_cast<char*>(pStack) - guardSize,
+                     guardSize + stackSize);
+        }
+    }
+
+    static Stats stats() {
+        State& state = getState();
+        ::pthread_mutex_lock(&state.mutex);
+        Stats result = state.stats;
+        ::pthread_mutex_unlock(&state.mutex);
+        return result;
+    }
+
+  private:
+    // stored at the bottom of the cached stack
+    struct Node {
+        Node* pNext;
+        std::size_t stackSize;
+        std::size_t guardSize;
+    };
+
+    struct State {
+        ::pthread_mutex_t mutex;
+        Node* pHead;
+        std::size_t size;
+        Stats stats;
+    };
+
+    static State& getState() {
+        // constant initialized, usable before main
+        static State state = {PTHREAD_MUTEX_INITIALIZER, NULL, 0, {0, 0}};
+        return state;
+    }
+};
+
+/**
+ * Exception that escaped a thread function, kept until the thread collecting
+ * the result (join, Future::get, ThreadPool::wait) rethrows it.
+ * With C++11 the original exception is kept in a std::exception_ptr, in C++98
+ * it is rethrown as a Thread::UncaughtException holding a copy of what().
+ * Only allocated when an exception is caught.
+ */
+class CapturedException {
+  public:
+    /**
+     * Run callable.call() and return what it threw, NULL when it returned
+     * normally.
+     * The unwinding of a cancelled thread is never caught.
+     */
+    template<typename T>
+    static CapturedException* call(T& callable) {
+        try {
+            callable.call();
+        }
+#ifdef __GLIBCXX__
+        catch (abi::__forced_unwind&) {
+            throw;
+        }
+#endif
+        catch (...) {
+            return current();
+        }
+        return NULL;
+    }
+
+    /**
+     * Throw the captured exception, can be called more than once.
+     */
+    void rethrow() const;
+
+  private:
+    // NULL when the copy cannot be allocated, the exception is then lost
+    static CapturedException* current() {
+        CapturedException* pException = new (std::nothrow) CapturedException;
+        if (pException != NULL) {
+#if __cplusplus >= 201103L
+            pException->exception_ = std::current_exception();
+#else
+            pException->id_ = ::pthread_self();
+            try {
+                throw;
+            }
+            catch (const std::exception& e) {
+                pException->setWhat(e.what());
+            }
+            catch (...) {
+                pException->setWhat("Unknown exception");
+            }
+#endif
+        }
+        return pException;
+    }
+
+#if __cplusplus >= 201103L
+    std::exception_ptr exception_;
+#else
+    void setWhat(const char* what) {
+        std::size_t i = 0;
+        for (; i + 1 < sizeof(what_) && what[i] != '\0'; ++i) {
+            what_[i] = what[i];
+        }
+        what_[i] = '\0';
+    }
+
+    ::pthread_t id_;
+    char what_[256];
+#endif
+};
+
+/**
+ * Type-erased bound call allocated from the ThreadDataPool.
+ * Executors queue them and run each one exactly once, or destroy it.
+ * A Task is a single pointer, lock-free containers can move it with the
+ * generic __atomic builtins.
+ */
+class Task {
+  public:
+    Task() :
+        pHolder_(NULL) {}
+
+    template<typename T>
+    static Task create(const T& threadData) {
+        void* pBlock = ThreadDataPool::allocate(sizeof(ThreadDataHolder<T>));
+        Task task;
+        try {
+            task.pHolder_ = new (pBlock) ThreadDataHolder<T>(threadData);
+        }
+        catch (...) {
+            ThreadDataPool::deallocate(pBlock, sizeof(ThreadDataHolder<T>));
+            throw;
+        }
+        return task;
+    }
+
+    bool empty() const {
+        return pHolder_ == NULL;
+    }
+
+    /**
+     * Call the bound call then release it.
+     * Return what the call threw, NULL when it returned normally.
+     */
+    CapturedException* run() {
+        return pHolder_->pRun(pHolder_);
+    }
+
+    /**
+     * Release the bound call without calling it.
+     */
+    void destroy() {
+        pHolder_->pDestroy(pHolder_);
+    }
+
+  private:
+    struct Holder {
+        CapturedException* (*pRun)(Holder*);
+        void (*pDestroy)(Holder*);
+    };
+
+    template<typename T>
+    struct ThreadDataHolder : public Holder {
+        explicit ThreadDataHolder(const T& value) :
+            Holder(),
+            threadData(value) {
+            pRun = &run;
+            pDestroy = &destroy;
+        }
+        static CapturedException* run(Holder* pHolder) {
+            ThreadDataHolder* pThreadDataHolder =
+                static_cast<ThreadDataHolder*>(pHolder);
+            CapturedException* pException =
+                CapturedException::call(pThreadDataHolder->threadData);
+            ThreadDataPool::destroy(pThreadDataHolder);
+            return pException;
+        }
+        static void destroy(Holder* pHolder) {
+            ThreadDataPool::destroy(static_cast<ThreadDataHolder*>(pHolder));
+        }
+        T threadData;
+    };
+
+    Holder* pHolder_;
+};
+
 class Thread {
   private:
+    template<typename Derived>
+    friend class Executor;
+    // use futexWait and futexWake to park their blocked callers
+    template<typename T>
+    friend class MpmcQueue;
+    friend struct FutureState;
+    friend struct StopState;
+    friend class Mutex;
+    friend class McsLock;
+    friend class RwLock;
+    friend class Barrier;
+    friend class Latch;
+    // atomic_wait.h
+    friend void atomic_wait(int* addr, int expected);
+    friend void atomic_notify_one(int* addr);
+    friend void atomic_notify_all(int* addr);
+    friend void park();
+    friend void unpark(Thread& thread);
+    // also starts its members with createThread
+    friend class ThreadGroup;
+
+    // in the thread local storage of each thread
+    struct ThreadState {
+        // ParkState, used by park and unpark
+        int parkToken;
+        // ExitState, used by join_for without BLET_THREAD_CLOCKJOIN
+        int exitState;
+    };
+
     ::pthread_t id_;
     bool isDetached_;
     ::pthread_attr_t* attr_;
+    // stack of the running thread taken from the StackCache
+    void* pStack_;
+    std::size_t stackSize_;
+    std::size_t guardSize_;
+    // already joined by is_finished, pExitValue_ waits for join
+    bool isReaped_;
+    void* pExitValue_;
+    bool isPersistent_;
+    int jobState_;
+    // state of the running thread, valid until it is joined
+    ThreadState* pState_;
+    void* pThreadData_;
+    CapturedException* (*pJob_)(void*);
+    // exception thrown by the last job in persistent mode
+    CapturedException* pException_;
+    // StartState, pState_ is published by the new thread before START_DONE
+    int isStarted_;
+    union InlineData {
+        char data[BLET_THREAD_INLINE_SIZE > 0 ? BLET_THREAD_INLINE_SIZE : 1];
+        long double alignLongDouble;
+        void* alignPointer;
+        void (*alignFunction)();
+    } inlineData_;
+
+    enum JobState {
+        JOB_IDLE,
+        JOB_RUNNING,
+        JOB_DONE,
+        JOB_EXIT
+    };
+
+    enum ParkState {
+        PARK_PARKED = -1,
+        PARK_EMPTY,
+        PARK_NOTIFIED,
+        // no Thread can unpark it, park returns at once
+        PARK_UNOWNED
+    };
+
+    enum StartState {
+        // the copy of the bound call threw
+        START_FAILED = -1,
+        START_PENDING,
+        START_DONE,
+        // the parent waits on isStarted_
+        START_WAITED
+    };
+
+    enum ExitState {
+        EXIT_RUNNING,
+        // join_for waits on exitState
+        EXIT_WAITED,
+        EXIT_DONE
+    };
 
   public:
     class Exception : public std::exception {
@@ -59,34 +735,308 @@ class Thread {
         ::pthread_t id_;
     };
 
+    /**
+     * Thrown by join in C++98 in place of an exception that escaped the
+     * thread function, what() is a copy of the original message.
+     */
+    class UncaughtException : public Exception {
+      public:
+        UncaughtException(const pthread_t& id, const char* message) :
+            Exception(id, message_) {
+            copy(message);
+        }
+        UncaughtException(const UncaughtException& rhs) :
+            Exception(rhs.id_, message_) {
+            copy(rhs.message_);
+        }
+        virtual ~UncaughtException() throw() {}
+
+      private:
+        void copy(const char* message) {
+            std::size_t i = 0;
+            for (; i + 1 < sizeof(message_) && message[i] != '\0'; ++i) {
+                message_[i] = message[i];
+            }
+            message_[i] = '\0';
+        }
+
+        char message_[256];
+    };
+
+    /**
+     * Value type describing how start creates the thread.
+     * A default Attributes creates it like pthread_create with a NULL
+     * pthread_attr_t.
+     */
+    class Attributes {
+      public:
+        Attributes() :
+            stackSize_(0),
+            guardSize_(0),
+            isGuardSize_(false),
+            isDetached_(false),
+            isScheduling_(false),
+            policy_(0),
+            priority_(0),
+            isAffinity_(false),
+            isStackCache_(false),
+            isLockStack_(false),
+            completionFd_(-1) {
+#ifdef __linux__
+            CPU_ZERO(&cpus_);
+#endif
+        }
+
+        /**
+         * 0 keeps the default size of the system.
+         */
+        void set_stack_size(std::size_t stackSize) {
+            stackSize_ = stackSize;
+        }
+
+        std::size_t stack_size() const {
+            return stackSize_;
+        }
+
+        void set_guard_size(std::size_t guardSize) {
+            guardSize_ = guardSize;
+            isGuardSize_ = true;
+        }
+
+        std::size_t guard_size() const {
+            return guardSize_;
+        }
+
+        /**
+         * Ignored in persistent mode, the worker is always joinable.
+         */
+        void set_detached(bool detached) {
+            isDetached_ = detached;
+        }
+
+        bool detached() const {
+            return isDetached_;
+        }
+
+        /**
+         * Use policy and priority instead of inheriting the scheduling of
+         * the thread calling start.
+         */
+        void set_scheduling(int policy, int priority) {
+            isScheduling_ = true;
+            policy_ = policy;
+            priority_ = priority;
+        }
+
+        int policy() const {
+            return policy_;
+        }
+
+        int priority() const {
+            return priority_;
+        }
+
+#ifdef __linux__
+        void set_affinity(const cpu_set_t& cpus) {
+            cpus_ = cpus;
+            isAffinity_ = true;
+        }
+
+        /**
+         * NULL when the thread can run on any CPU.
+         */
+        const cpu_set_t* affinity() const {
+            return isAffinity_ ? &cpus_ : NULL;
+        }
+#endif
+
+        /**
+         * Take the stack from the StackCache and give it back on join.
+         * Not used by detached threads, whose end cannot be known.
+         */
+        void set_stack_cache(bool stackCache) {
+            isStackCache_ = stackCache;
+        }
+
+        bool stack_cache() const {
+            return isStackCache_;
+        }
+
+        /**
+         * Map and mlock the whole stack before the thread is created, so
+         * the thread never page faults on it.
+         * The stack comes from the StackCache and stays locked there, a
+         * detached thread cannot use it.
+         */
+        void set_lock_stack(bool lockStack) {
+            isLockStack_ = lockStack;
+        }
+
+        bool lock_stack() const {
+            return isLockStack_;
+        }
+
+        /**
+         * Real-time profile: explicit policy (SCHED_FIFO or SCHED_RR) and
+         * priority, and a locked stack.
+         * Needs CAP_SYS_NICE and CAP_IPC_LOCK or matching RLIMIT_RTPRIO and
+         * RLIMIT_MEMLOCK, start throws otherwise.
+         */
+        void set_realtime(int policy, int priority) {
+            set_scheduling(policy, priority);
+            isLockStack_ = true;
+        }
+
+        /**
+         * Add 1 to this eventfd once the bound call has returned, thrown or
+         * been canceled, so an epoll loop can wait for it before join.
+         * The fd must stay open until then, -1 disables it.
+         * A ThreadGroup signals it once per batch instead of per member.
+         */
+        void set_completion_fd(int fd) {
+            completionFd_ = fd;
+        }
+
+        int completion_fd() const {
+            return completionFd_;
+        }
+
+      private:
+        friend class Thread;
+
+        bool isDefault() const {
+            return stackSize_ == 0 && !isGuardSize_ && !isDetached_ &&
+                   !isScheduling_ && !isAffinity_ && !isStackCache_ &&
+                   !isLockStack_;
+        }
+
+        std::size_t stackSize_;
+        std::size_t guardSize_;
+        bool isGuardSize_;
+        bool isDetached_;
+        bool isScheduling_;
+        int policy_;
+        int priority_;
+        bool isAffinity_;
+#ifdef __linux__
+        cpu_set_t cpus_;
+#endif
+        bool isStackCache_;
+        bool isLockStack_;
+        int completionFd_;
+    };
+
+  private:
+    // declared after its type, applied by the next start
+    Attributes attributes_;
+
+  public:
     Thread() :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {}
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {}
+
+    explicit Thread(const Attributes& attributes) :
+        id_(0),
+        isDetached_(false),
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE),
+        attributes_(attributes) {}
 
     ~Thread() {
-        if (id_ != 0 && !isDetached_) {
-            ::pthread_join(id_, NULL);
+        if (isPersistent_) {
+            stopWorker();
+        }
+        else if (id_ != 0 && !isDetached_) {
+            void* pResult = reap();
+            releaseStack();
+            // a destructor cannot throw, the exception is dropped
+            delete capturedException(pResult);
         }
     }
 
+    /**
+     * In persistent mode, wait for the current job instead of the thread.
+     * Rethrow the exception that escaped the thread function or the job.
+     */
     void join() {
-        if (id_ == 0 || isDetached_) {
+        if (!joinable()) {
             throw Exception(id_, "Thread is not joinable");
         }
-        ::pthread_join(id_, NULL);
+        if (isPersistent_) {
+            waitJob();
+            joinJob();
+            return;
+        }
+        void* pResult = reap();
         id_ = 0;
+        releaseStack();
+        rethrow(capturedException(pResult));
+    }
+
+#ifdef __linux__
+    /**
+     * Join only if the thread function has already returned.
+     * Return false without blocking otherwise.
+     */
+    bool try_join() {
+        return timedJoin(NULL);
     }
 
+    /**
+     * Join if the thread function returns within milliseconds.
+     * Return false on timeout, the thread keeps running and stays joinable.
+     */
+    bool join_for(long milliseconds) {
+        struct timespec timeout;
+        timeout.tv_sec = milliseconds / 1000;
+        timeout.tv_nsec = milliseconds % 1000 * 1000000L;
+        return timedJoin(&timeout);
+    }
+
+    /**
+     * True when join would not block, false when not joinable.
+     * The thread is reaped here but its exception waits for join.
+     */
+    bool is_finished() {
+        if (!joinable()) {
+            return false;
+        }
+        if (isPersistent_) {
+            return __atomic_load_n(&jobState_, __ATOMIC_ACQUIRE) != JOB_RUNNING;
+        }
+        if (!isReaped_ && ::pthread_tryjoin_np(id_, &pExitValue_) == 0) {
+            isReaped_ = true;
+        }
+        return isReaped_;
+    }
+#endif
+
     bool joinable() const {
+        if (isPersistent_) {
+            return __atomic_load_n(&jobState_, __ATOMIC_RELAXED) != JOB_IDLE;
+        }
         return id_ != 0 && !isDetached_;
     }
 
     void cancel() {
-        if (id_ == 0 || isDetached_) {
+        if (!joinable() || isPersistent_) {
             throw Exception(id_, "Thread is not cancelable");
         }
 
+        if (isReaped_) {
+            // already returned
+            return;
+        }
         int result = ::pthread_cancel(id_);
         if (result != 0) {
             throw Exception(id_, "Failed to cancel thread");
@@ -94,10 +1044,19 @@ class Thread {
     }
 
     void detach() {
-        if (id_ == 0 || isDetached_) {
+        // a cached or locked stack is only given back by join
+        if (!joinable() || isPersistent_ || (pStack_ != NULL && !isReaped_)) {
             throw Exception(id_, "Thread is not detachable");
         }
 
+        if (isReaped_) {
+            isReaped_ = false;
+            releaseStack();
+            delete capturedException(pExitValue_);
+            isDetached_ = true;
+            return;
+        }
+        disown();
         int result = ::pthread_detach(id_);
         if (result != 0) {
             throw Exception(id_, "Failed to detach thread");
@@ -113,29 +1072,745 @@ class Thread {
         return id_;
     }
 
+    /**
+     * Used as is by the next start instead of the Attributes, must outlive
+     * it.
+     */
     void set_attr(pthread_attr_t* attr) {
         attr_ = attr;
     }
 
+    /**
+     * Apply to the next start.
+     */
+    void set_attributes(const Attributes& attributes) {
+        attributes_ = attributes;
+    }
+
+    const Attributes& attributes() const {
+        return attributes_;
+    }
+
+    /**
+     * In persistent mode the first start creates a worker thread that parks
+     * after each job and runs the bound call of the next start, join waits
+     * for the current job.
+     * The worker stops when persistent mode is disabled or on destruction.
+     */
+    void set_persistent(bool persistent) {
+        if (isPersistent_ ? joinable() : id_ != 0) {
+            throw Exception(id_, "Thread already started");
+        }
+        if (isPersistent_ && !persistent) {
+            stopWorker();
+        }
+        isPersistent_ = persistent;
+    }
+
+    bool persistent() const {
+        return isPersistent_;
+    }
+
+    /**
+     * Call pFunction(data) in the calling thread when it exits, once its
+     * function has returned, thrown or been canceled, before join returns.
+     * The last registered runs first, pFunction must not throw.
+     * On the main thread they only run on pthread_exit.
+     */
+    static void at_exit(void (*pFunction)(void*), void* data) {
+        ::pthread_key_t key = exitKey();
+        ExitHandler handler = {
+            pFunction, data,
+            static_cast<ExitHandler*>(::pthread_getspecific(key))};
+        ::pthread_setspecific(key, ThreadDataPool::create(handler));
+    }
+
+  private:
+    struct ExitHandler {
+        void (*pFunction)(void*);
+        void* data;
+        ExitHandler* pNext;
+    };
+
+    // key destructors also run when the thread is canceled
+    static ::pthread_key_t exitKey() {
+        // constant initialized, usable before main
+        static ::pthread_once_t once = PTHREAD_ONCE_INIT;
+        ::pthread_once(&once, &createExitKey);
+        return exitKeyStorage();
+    }
+
+    static ::pthread_key_t& exitKeyStorage() {
+        static ::pthread_key_t key;
+        return key;
+    }
+
+    static void createExitKey() {
+        ::pthread_key_create(&exitKeyStorage(), &runExitHandlers);
+    }
+
+    // handlers registered from a handler land in the next key destructor pass
+    static void runExitHandlers(void* value) {
+        ExitHandler* pHandler = static_cast<ExitHandler*>(value);
+        while (pHandler != NULL) {
+            ExitHandler handler = *pHandler;
+            ThreadDataPool::destroy(pHandler);
+            handler.pFunction(handler.data);
+            pHandler = handler.pNext;
+        }
+    }
+
+    /**
+     * Launch the thread on a copy of threadData.
+     * Small bound calls are copied by the child straight from threadData
+     * before start returns, an exception of the copy is rethrown here.
+     * Larger ones are moved to the ThreadDataPool.
+     * In persistent mode the bound call is handed to the parked worker.
+     */
+    template<typename T>
+    void create(const T& threadData) {
+        if (isPersistent_) {
+            createJob(threadData);
+            return;
+        }
+        if (id_ != 0) {
+            throw Exception(id_, "Thread already started");
+        }
+        if (isInline<T>()) {
+            // read by the child before isStarted_ is set
+            pThreadData_ = const_cast<T*>(&threadData);
+            __atomic_store_n(&isStarted_, START_PENDING, __ATOMIC_RELAXED);
+            const char* error =
+                createThread(&startThreadInline<T>, this, true);
+            if (error != NULL) {
+                throw Exception(id_, error);
+            }
+            waitStarted();
+            if (__atomic_load_n(&isStarted_, __ATOMIC_RELAXED) ==
+                START_FAILED) {
+                rethrow(abortStart());
+            }
+        }
+        else {
+            HeapThreadData<T>* pThreadData =
+                ThreadDataPool::create<HeapThreadData<T> >(threadData, this);
+            // set by the child, waited for when pState_ is needed
+            __atomic_store_n(&isStarted_, START_PENDING, __ATOMIC_RELAXED);
+            const char* error =
+                createThread(&startThreadHeap<T>, pThreadData, true);
+            if (error != NULL) {
+                ThreadDataPool::destroy(pThreadData);
+                throw Exception(id_, error);
+            }
+        }
+    }
+
+    /**
+     * pthread_create with attr_ or the Attributes.
+     * Return the message of the Exception to throw, NULL on success.
+     */
+    const char* createThread(void* (*pStart)(void*), void* data,
+                             bool isDetachable) {
+        pStack_ = NULL;
+        if (attr_ != NULL || attributes_.isDefault()) {
+            if (::pthread_create(&id_, attr_, pStart, data) != 0) {
+                return "Failed to create thread";
+            }
+            return NULL;
+        }
+        bool isDetached = isDetachable && attributes_.isDetached_;
+        if (isDetached && attributes_.isLockStack_) {
+            return "Detached thread cannot lock its stack";
+        }
+        const char* error = NULL;
+        ::pthread_attr_t attr;
+        ::pthread_attr_init(&attr);
+        int result = 0;
+        std::size_t stackSize = attributes_.stackSize_;
+        std::size_t guardSize = attributes_.guardSize_;
+        if (stackSize == 0) {
+            ::pthread_attr_getstacksize(&attr, &stackSize);
+        }
+        if (!attributes_.isGuardSize_) {
+            ::pthread_attr_getguardsize(&attr, &guardSize);
+        }
+        if ((attributes_.isStackCache_ || attributes_.isLockStack_) &&
+            !isDetached) {
+            // a stack given by the user has no guard added by pthread
+            std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+            stackSize_ = (stackSize + pageSize - 1) / pageSize * pageSize;
+            guardSize_ = (guardSize + pageSize - 1) / pageSize * pageSize;
+            pStack_ = StackCache::allocate(stackSize_, guardSize_);
+            if (pStack_ == NULL) {
+                result = EAGAIN;
+            }
+            else {
+                result = ::pthread_attr_setstack(&attr, pStack_, stackSize_);
+            }
+            // mlock also faults every page in
+            if (result == 0 && attributes_.isLockStack_ &&
+                ::mlock(pStack_, stackSize_) != 0) {
+                error = "Failed to lock thread stack";
+            }
+        }
+        else {
+            if (attributes_.stackSize_ != 0) {
+                result = ::pthread_attr_setstacksize(&attr, stackSize);
+            }
+            if (result == 0 && attributes_.isGuardSize_) {
+                result = ::pthread_attr_setguardsize(&attr, guardSize);
+            }
+        }
+        if (result == 0 && isDetached) {
+            result =
+                ::pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        }
+        if (result == 0 && attributes_.isScheduling_) {
+            ::sched_param param;
+            param.sched_priority = attributes_.priority_;
+            result = ::pthread_attr_setinheritsched(&attr,
+                                                    PTHREAD_EXPLICIT_SCHED);
+            if (result == 0) {
+                result =
+                    ::pthread_attr_setschedpolicy(&attr, attributes_.policy_);
+            }
+            if (result == 0) {
+                result = ::pthread_attr_setschedparam(&attr, &param);
+            }
+        }
+#ifdef __linux__
+        if (result == 0 && attributes_.isAffinity_) {
+            result = ::pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t),
+                                                   &attributes_.cpus_);
+        }
+#endif
+        if (result == 0 && error == NULL) {
+            result = ::pthread_create(&id_, &attr, pStart, data);
+            if (result == EPERM && attributes_.isScheduling_) {
+                error = "Failed to set thread scheduling";
+            }
+        }
+        ::pthread_attr_destroy(&attr);
+        if (result != 0 && error == NULL) {
+            error = "Failed to create thread";
+        }
+        if (error != NULL) {
+            releaseStack();
+        }
+        else if (isDetached) {
+            isDetached_ = true;
+        }
+        return error;
+    }
+
+    /**
+     * pthread_join or take the exit value already received by is_finished.
+     */
+    void* reap() {
+        if (isReaped_) {
+            isReaped_ = false;
+            return pExitValue_;
+        }
+        void* pResult = NULL;
+        ::pthread_join(id_, &pResult);
+        return pResult;
+    }
+
+#ifdef __linux__
+    /**
+     * Wait at most pTimeout, NULL polls once.
+     * The kernel clears the thread id word at exit and wakes its futex,
+     * pthread_tryjoin_np and pthread_clockjoin_np wait on it. The deadline is
+     * on CLOCK_MONOTONIC so that a change of the wall clock does not move it.
+     */
+    bool timedJoin(const struct timespec* pTimeout) {
+        if (!joinable()) {
+            throw Exception(id_, "Thread is not joinable");
+        }
+        if (isPersistent_) {
+            if (!waitWhile(&jobState_, JOB_RUNNING, pTimeout)) {
+                return false;
+            }
+            joinJob();
+            return true;
+        }
+        if (!isReaped_) {
+            int result;
+            if (pTimeout == NULL) {
+                result = ::pthread_tryjoin_np(id_, &pExitValue_);
+            }
+            else {
+#if BLET_THREAD_CLOCKJOIN
+                struct timespec deadline =
+                    clockDeadline(CLOCK_MONOTONIC, *pTimeout);
+                result = ::pthread_clockjoin_np(id_, &pExitValue_,
+                                                CLOCK_MONOTONIC, &deadline);
+#else
+                result = waitExit(*pTimeout)
+                             ? ::pthread_join(id_, &pExitValue_)
+                             : ETIMEDOUT;
+#endif
+            }
+            if (result != 0) {
+                return false;
+            }
+            isReaped_ = true;
+        }
+        join();
+        return true;
+    }
+
+#if !BLET_THREAD_CLOCKJOIN
+    /**
+     * Wait at most timeout for the thread function to return.
+     */
+    bool waitExit(const struct timespec& timeout) {
+        int* pExitState = &runningState()->exitState;
+        int state = EXIT_RUNNING;
+        __atomic_compare_exchange_n(pExitState, &state, EXIT_WAITED, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+        return waitWhile(pExitState, EXIT_WAITED, &timeout);
+    }
+#endif
+
+    /**
+     * Wait at most pTimeout while the futex word is value, NULL polls once.
+     */
+    static bool waitWhile(int* pWord, int value,
+                          const struct timespec* pTimeout) {
+        struct timespec deadline = {0, 0};
+        if (pTimeout != NULL) {
+            deadline = clockDeadline(CLOCK_MONOTONIC, *pTimeout);
+        }
+        while (__atomic_load_n(pWord, __ATOMIC_ACQUIRE) == value) {
+            struct timespec remaining;
+            if (pTimeout == NULL || !remainingTime(deadline, &remaining)) {
+                return false;
+            }
+            futexWait(pWord, value, &remaining);
+        }
+        return true;
+    }
+
+    static struct timespec clockDeadline(clockid_t clock,
+                                         const struct timespec& timeout) {
+        struct timespec deadline;
+        ::clock_gettime(clock, &deadline);
+        long nsec = deadline.tv_nsec + timeout.tv_nsec;
+        deadline.tv_sec += timeout.tv_sec + nsec / 1000000000L;
+        deadline.tv_nsec = nsec % 1000000000L;
+        return deadline;
+    }
+
+    /**
+     * Time left before the CLOCK_MONOTONIC deadline, false once passed.
+     */
+    static bool remainingTime(const struct timespec& deadline,
+                              struct timespec* pRemaining) {
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        pRemaining->tv_sec = deadline.tv_sec - now.tv_sec;
+        pRemaining->tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (pRemaining->tv_nsec < 0) {
+            pRemaining->tv_nsec += 1000000000L;
+            --pRemaining->tv_sec;
+        }
+        return pRemaining->tv_sec >= 0;
+    }
+#endif
+
+    // the thread running on pStack_ must be joined
+    void releaseStack() {
+        if (pStack_ != NULL) {
+            StackCache::deallocate(pStack_, stackSize_, guardSize_);
+            pStack_ = NULL;
+        }
+    }
+
+    template<typename T>
+    static bool isInline() {
+        return sizeof(T) <= BLET_THREAD_INLINE_SIZE;
+    }
+
+    template<typename T>
+    void createJob(const T& threadData) {
+        if (joinable()) {
+            throw Exception(id_, "Thread already started");
+        }
+        if (isInline<T>()) {
+            pThreadData_ = new (inlineData_.data) T(threadData);
+        }
+        else {
+            pThreadData_ = ThreadDataPool::create(threadData);
+        }
+        pJob_ = &runJob<T>;
+        pException_ = NULL;
+        __atomic_store_n(&jobState_, JOB_RUNNING, __ATOMIC_RELEASE);
+        if (id_ == 0) {
+            __atomic_store_n(&isStarted_, START_PENDING, __ATOMIC_RELAXED);
+            const char* error = createThread(&startWorker, this, false);
+            if (error != NULL) {
+                id_ = 0;
+                jobState_ = JOB_IDLE;
+                destroyJob(reinterpret_cast<T*>(pThreadData_));
+                throw Exception(id_, error);
+            }
+        }
+        else {
+            futexWake(&jobState_);
+        }
+    }
+
+    template<typename T>
+    static CapturedException* runJob(void* data) {
+        T* pThreadData = reinterpret_cast<T*>(data);
+        CapturedException* pException = CapturedException::call(*pThreadData);
+        destroyJob(pThreadData);
+        return pException;
+    }
+
+    template<typename T>
+    static void destroyJob(T* pThreadData) {
+        if (isInline<T>()) {
+            pThreadData->~T();
+        }
+        else {
+            ThreadDataPool::destroy(pThreadData);
+        }
+    }
+
+    static void* startWorker(void* data) {
+        Thread* pThread = reinterpret_cast<Thread*>(data);
+        setStarted(pThread);
+        for (;;) {
+            int state = __atomic_load_n(&pThread->jobState_, __ATOMIC_ACQUIRE);
+            if (state == JOB_RUNNING) {
+                // pThread may be destroyed once the job is done
+                int completionFd = pThread->attributes_.completionFd_;
+                pThread->pException_ = pThread->pJob_(pThread->pThreadData_);
+                __atomic_store_n(&pThread->jobState_, JOB_DONE,
+                                 __ATOMIC_RELEASE);
+                futexWake(&pThread->jobState_);
+                notifyCompletion(completionFd);
+            }
+            else if (state == JOB_EXIT) {
+                return NULL;
+            }
+            else {
+                futexWait(&pThread->jobState_, state);
+            }
+        }
+    }
+
+    void waitJob() {
+        while (__atomic_load_n(&jobState_, __ATOMIC_ACQUIRE) == JOB_RUNNING) {
+            futexWait(&jobState_, JOB_RUNNING);
+        }
+    }
+
+    // rethrow the exception of the finished job
+    void joinJob() {
+        CapturedException* pException = pException_;
+        pException_ = NULL;
+        __atomic_store_n(&jobState_, JOB_IDLE, __ATOMIC_RELAXED);
+        rethrow(pException);
+    }
+
+    void stopWorker() {
+        if (id_ != 0) {
+            waitJob();
+            __atomic_store_n(&jobState_, JOB_EXIT, __ATOMIC_RELEASE);
+            futexWake(&jobState_);
+            ::pthread_join(id_, NULL);
+            id_ = 0;
+            releaseStack();
+            jobState_ = JOB_IDLE;
+            // never joined
+            delete pException_;
+            pException_ = NULL;
+        }
+    }
+
+    // the copy of the bound call threw in the child, return its exception
+    CapturedException* abortStart() {
+        if (!isDetached_) {
+            ::pthread_join(id_, NULL);
+            releaseStack();
+        }
+        id_ = 0;
+        isDetached_ = false;
+        CapturedException* pException = pException_;
+        pException_ = NULL;
+        return pException;
+    }
+
+    // copy the bound call of the parent, called through CapturedException
+    template<typename T>
+    struct InlineCopy {
+        void call() {
+            pThreadData = new (buffer.data) T(*pSource);
+        }
+        const T* pSource;
+        T* pThreadData;
+        InlineData buffer;
+    };
+
+    template<typename T>
+    static void* startThreadInline(void* data) {
+        Thread* pThread = reinterpret_cast<Thread*>(data);
+        // declared first, signals once the arguments are destroyed
+        Completion completion(-1);
+        InlineCopy<T> copy;
+        copy.pSource = reinterpret_cast<const T*>(pThread->pThreadData_);
+        copy.pThreadData = NULL;
+        CapturedException* pException = CapturedException::call(copy);
+        if (copy.pThreadData == NULL) {
+            // lost when it cannot be allocated, start then returns unstarted
+            pThread->pException_ = pException;
+            notifyStarted(pThread, START_FAILED);
+            return NULL;
+        }
+        InlineGuard<T> guard(copy.pThreadData);
+        completion.fd_ = pThread->attributes_.completionFd_;
+        if (pThread->isCreatedDetached()) {
+            // never unparked
+            notifyStarted(pThread, START_DONE);
+        }
+        else {
+            setStarted(pThread);
+        }
+        return exitValue(CapturedException::call(*copy.pThreadData));
+    }
+
+    // also destroys the copy on the forced unwind of pthread_cancel
+    template<typename T>
+    struct InlineGuard {
+        explicit InlineGuard(T* pValue) :
+            pValue_(pValue) {}
+        ~InlineGuard() {
+            pValue_->~T();
+        }
+        T* pValue_;
+    };
+
+    // bound call moved to the ThreadDataPool with its completion fd
+    template<typename T>
+    struct HeapThreadData {
+        HeapThreadData(const T& threadData, Thread* pThread) :
+            threadData_(threadData),
+            completionFd_(pThread->attributes_.completionFd_),
+            pThread_(pThread->isCreatedDetached() ? NULL : pThread) {}
+        T threadData_;
+        int completionFd_;
+        // NULL when the thread is created detached
+        Thread* pThread_;
+    };
+
+    template<typename T>
+    static void* startThreadHeap(void* data) {
+        HeapThreadData<T>* pThreadData =
+            reinterpret_cast<HeapThreadData<T>*>(data);
+        Completion completion(pThreadData->completionFd_);
+        if (pThreadData->pThread_ != NULL) {
+            setStarted(pThreadData->pThread_);
+        }
+        CapturedException* pException = NULL;
+        {
+            // the bound call and its arguments are also released by the
+            // forced unwind of pthread_cancel
+            PoolGuard<HeapThreadData<T> > guard(pThreadData);
+            pException = CapturedException::call(pThreadData->threadData_);
+        }
+        return exitValue(pException);
+    }
+
+    template<typename T>
+    struct PoolGuard {
+        explicit PoolGuard(T* pValue) :
+            pValue_(pValue) {}
+        ~PoolGuard() {
+            ThreadDataPool::destroy(pValue_);
+        }
+        T* pValue_;
+    };
+
+    /**
+     * Signal join_for and the completion fd when the trampoline returns, the
+     * destructor also runs on the forced unwind of pthread_cancel.
+     */
+    struct Completion {
+        explicit Completion(int fd) :
+            fd_(fd) {}
+        ~Completion() {
+#if !BLET_THREAD_CLOCKJOIN
+            notifyExit();
+#endif
+            notifyCompletion(fd_);
+        }
+        int fd_;
+    };
+
+    /**
+     * State of the calling thread, owned by the Thread that started it until
+     * joined or detached.
+     */
+    static ThreadState& threadState() {
+        static __thread ThreadState state = {PARK_UNOWNED, EXIT_RUNNING};
+        return state;
+    }
+
+    /**
+     * Publish the state of the calling thread to pThread.
+     * pThread may be destroyed as soon as isStarted_ is set.
+     */
+    static void setStarted(Thread* pThread) {
+        ThreadState& state = threadState();
+        __atomic_store_n(&state.parkToken, PARK_EMPTY, __ATOMIC_RELAXED);
+        pThread->pState_ = &state;
+        notifyStarted(pThread, START_DONE);
+    }
+
+    // only enters the kernel when the parent waits
+    static void notifyStarted(Thread* pThread, int startState) {
+        if (__atomic_exchange_n(&pThread->isStarted_, startState,
+                                __ATOMIC_ACQ_REL) == START_WAITED) {
+            futexWake(&pThread->isStarted_);
+        }
+    }
+
+#if !BLET_THREAD_CLOCKJOIN
+    // only enters the kernel when join_for waits
+    static void notifyExit() {
+        int* pExitState = &threadState().exitState;
+        if (__atomic_exchange_n(pExitState, EXIT_DONE, __ATOMIC_RELEASE) ==
+            EXIT_WAITED) {
+            futexWake(pExitState);
+        }
+    }
+#endif
+
+    void waitStarted() {
+        int started = START_PENDING;
+        __atomic_compare_exchange_n(&isStarted_, &started, START_WAITED,
+                                    false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&isStarted_, __ATOMIC_ACQUIRE) ==
+               START_WAITED) {
+            futexWait(&isStarted_, START_WAITED);
+        }
+    }
+
+    // state of the thread while its storage is alive and reachable
+    ThreadState* runningState() {
+        if (id_ == 0 || isDetached_ || isReaped_) {
+            return NULL;
+        }
+        waitStarted();
+        return pState_;
+    }
+
+    // a detached thread cannot be unparked anymore, wake it for good
+    void disown() {
+        ThreadState* pState = runningState();
+        if (pState != NULL &&
+            __atomic_exchange_n(&pState->parkToken, PARK_UNOWNED,
+                                __ATOMIC_RELEASE) == PARK_PARKED) {
+            futexWake(&pState->parkToken);
+        }
+    }
+
+    bool isCreatedDetached() const {
+        return attr_ == NULL && attributes_.isDetached_;
+    }
+
+    static void notifyCompletion(int fd) {
+        if (fd >= 0) {
+            uint64_t value = 1;
+            ssize_t result = ::write(fd, &value, sizeof(value));
+            (void)result;
+        }
+    }
+
+    /**
+     * The exception is the exit value of the thread, received by join.
+     * Nobody joins a detached thread, the exception is dropped.
+     */
+    static void* exitValue(CapturedException* pException) {
+#ifdef __GLIBC__
+        if (pException != NULL) {
+            ::pthread_attr_t attr;
+            int detachState = PTHREAD_CREATE_JOINABLE;
+            if (::pthread_getattr_np(::pthread_self(), &attr) == 0) {
+                ::pthread_attr_getdetachstate(&attr, &detachState);
+                ::pthread_attr_destroy(&attr);
+            }
+            if (detachState == PTHREAD_CREATE_DETACHED) {
+                delete pException;
+                return NULL;
+            }
+        }
+#endif
+        return pException;
+    }
+
+    static CapturedException* capturedException(void* pResult) {
+        if (pResult == PTHREAD_CANCELED) {
+            return NULL;
+        }
+        return reinterpret_cast<CapturedException*>(pResult);
+    }
+
+    static void rethrow(CapturedException* pException) {
+        if (pException != NULL) {
+            try {
+                pException->rethrow();
+            }
+            catch (...) {
+                delete pException;
+                throw;
+            }
+        }
+    }
+
+    /**
+     * pTimeout is relative, NULL waits until woken.
+     */
+    static void futexWait(int* addr, int expected,
+                          const struct timespec* pTimeout = NULL) {
+#ifdef __linux__
+        ::syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, pTimeout,
+                  NULL, 0);
+#else
+        (void)addr;
+        (void)expected;
+        (void)pTimeout;
+        ::sched_yield();
+#endif
+    }
+
+    static void futexWake(int* addr, int count = INT_MAX) {
+#ifdef __linux__
+        ::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+        (void)addr;
+        (void)count;
+#endif
+    }
+
   public:
     Thread(void (*pFunction)()) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction);
     }
 
     void start(void (*pFunction)()) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic0* pThreadData = new ThreadDataStatic0(pFunction);
-        int result =
-            ::pthread_create(&id_, attr_, &startThreadStatic0, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic0(pFunction));
     }
 
   private:
@@ -148,36 +1823,23 @@ class Thread {
         void (*pFunction_)();
     };
 
-    static void* startThreadStatic0(void* data) {
-        ThreadDataStatic0* pThreadData =
-            reinterpret_cast<ThreadDataStatic0*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1>
     Thread(void (*pFunction)(A1), A1 a1) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1);
     }
 
     template<typename A1>
     void start(void (*pFunction)(A1), A1 a1) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic1<A1>* pThreadData =
-            new ThreadDataStatic1<A1>(pFunction, a1);
-        int result =
-            ::pthread_create(&id_, attr_, &startThreadStatic1<A1>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic1<A1>(pFunction, a1));
     }
 
   private:
@@ -193,37 +1855,23 @@ class Thread {
         A1 a1_;
     };
 
-    template<typename A1>
-    static void* startThreadStatic1(void* data) {
-        ThreadDataStatic1<A1>* pThreadData =
-            reinterpret_cast<ThreadDataStatic1<A1>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2>
     Thread(void (*pFunction)(A1, A2), A1 a1, A2 a2) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2);
     }
 
     template<typename A1, typename A2>
     void start(void (*pFunction)(A1, A2), A1 a1, A2 a2) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic2<A1, A2>* pThreadData =
-            new ThreadDataStatic2<A1, A2>(pFunction, a1, a2);
-        int result = ::pthread_create(&id_, attr_, &startThreadStatic2<A1, A2>,
-                                      pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic2<A1, A2>(pFunction, a1, a2));
     }
 
   private:
@@ -241,37 +1889,23 @@ class Thread {
         A2 a2_;
     };
 
-    template<typename A1, typename A2>
-    static void* startThreadStatic2(void* data) {
-        ThreadDataStatic2<A1, A2>* pThreadData =
-            reinterpret_cast<ThreadDataStatic2<A1, A2>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3>
     Thread(void (*pFunction)(A1, A2, A3), A1 a1, A2 a2, A3 a3) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3);
     }
 
     template<typename A1, typename A2, typename A3>
     void start(void (*pFunction)(A1, A2, A3), A1 a1, A2 a2, A3 a3) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic3<A1, A2, A3>* pThreadData =
-            new ThreadDataStatic3<A1, A2, A3>(pFunction, a1, a2, a3);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic3<A1, A2, A3>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic3<A1, A2, A3>(pFunction, a1, a2, a3));
     }
 
   private:
@@ -291,37 +1925,23 @@ class Thread {
         A3 a3_;
     };
 
-    template<typename A1, typename A2, typename A3>
-    static void* startThreadStatic3(void* data) {
-        ThreadDataStatic3<A1, A2, A3>* pThreadData =
-            reinterpret_cast<ThreadDataStatic3<A1, A2, A3>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4>
     Thread(void (*pFunction)(A1, A2, A3, A4), A1 a1, A2 a2, A3 a3, A4 a4) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4);
     }
 
     template<typename A1, typename A2, typename A3, typename A4>
     void start(void (*pFunction)(A1, A2, A3, A4), A1 a1, A2 a2, A3 a3, A4 a4) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic4<A1, A2, A3, A4>* pThreadData =
-            new ThreadDataStatic4<A1, A2, A3, A4>(pFunction, a1, a2, a3, a4);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic4<A1, A2, A3, A4>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic4<A1, A2, A3, A4>(pFunction, a1, a2, a3, a4));
     }
 
   private:
@@ -344,40 +1964,26 @@ class Thread {
         A4 a4_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4>
-    static void* startThreadStatic4(void* data) {
-        ThreadDataStatic4<A1, A2, A3, A4>* pThreadData =
-            reinterpret_cast<ThreadDataStatic4<A1, A2, A3, A4>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5>
     Thread(void (*pFunction)(A1, A2, A3, A4, A5), A1 a1, A2 a2, A3 a3, A4 a4,
            A5 a5) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5);
     }
 
     template<typename A1, typename A2, typename A3, typename A4, typename A5>
     void start(void (*pFunction)(A1, A2, A3, A4, A5), A1 a1, A2 a2, A3 a3,
                A4 a4, A5 a5) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic5<A1, A2, A3, A4, A5>* pThreadData =
-            new ThreadDataStatic5<A1, A2, A3, A4, A5>(pFunction, a1, a2, a3, a4,
-                                                      a5);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic5<A1, A2, A3, A4, A5>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic5<A1, A2, A3, A4, A5>(
+            pFunction, a1, a2, a3, a4, a5));
     }
 
   private:
@@ -402,15 +2008,6 @@ class Thread {
         A5 a5_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5>
-    static void* startThreadStatic5(void* data) {
-        ThreadDataStatic5<A1, A2, A3, A4, A5>* pThreadData =
-            reinterpret_cast<ThreadDataStatic5<A1, A2, A3, A4, A5>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5,
              typename A6>
@@ -418,7 +2015,12 @@ class Thread {
            A4 a4, A5 a5, A6 a6) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5, a6);
     }
 
@@ -426,19 +2028,8 @@ class Thread {
              typename A6>
     void start(void (*pFunction)(A1, A2, A3, A4, A5, A6), A1 a1, A2 a2, A3 a3,
                A4 a4, A5 a5, A6 a6) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic6<A1, A2, A3, A4, A5, A6>* pThreadData =
-            new ThreadDataStatic6<A1, A2, A3, A4, A5, A6>(pFunction, a1, a2, a3,
-                                                          a4, a5, a6);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic6<A1, A2, A3, A4, A5, A6>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic6<A1, A2, A3, A4, A5, A6>(
+            pFunction, a1, a2, a3, a4, a5, a6));
     }
 
   private:
@@ -466,16 +2057,6 @@ class Thread {
         A6 a6_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5,
-             typename A6>
-    static void* startThreadStatic6(void* data) {
-        ThreadDataStatic6<A1, A2, A3, A4, A5, A6>* pThreadData =
-            reinterpret_cast<ThreadDataStatic6<A1, A2, A3, A4, A5, A6>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5,
              typename A6, typename A7>
@@ -483,7 +2064,12 @@ class Thread {
            A4 a4, A5 a5, A6 a6, A7 a7) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5, a6, a7);
     }
 
@@ -491,19 +2077,8 @@ class Thread {
              typename A6, typename A7>
     void start(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7), A1 a1, A2 a2,
                A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            new ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>(
-                pFunction, a1, a2, a3, a4, a5, a6, a7);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic7<A1, A2, A3, A4, A5, A6, A7>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7));
     }
 
   private:
@@ -533,17 +2108,6 @@ class Thread {
         A7 a7_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5,
-             typename A6, typename A7>
-    static void* startThreadStatic7(void* data) {
-        ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            reinterpret_cast<ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5,
              typename A6, typename A7, typename A8>
@@ -551,7 +2115,12 @@ class Thread {
            A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5, a6, a7, a8);
     }
 
@@ -559,19 +2128,8 @@ class Thread {
              typename A6, typename A7, typename A8>
     void start(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8), A1 a1, A2 a2,
                A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>* pThreadData =
-            new ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>(
-                pFunction, a1, a2, a3, a4, a5, a6, a7, a8);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadStatic8<A1, A2, A3, A4, A5, A6, A7, A8>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8));
     }
 
   private:
@@ -604,17 +2162,6 @@ class Thread {
         A8 a8_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5,
-             typename A6, typename A7, typename A8>
-    static void* startThreadStatic8(void* data) {
-        ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>* pThreadData =
-            reinterpret_cast<
-                ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5,
              typename A6, typename A7, typename A8, typename A9>
@@ -622,7 +2169,12 @@ class Thread {
            A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9);
     }
 
@@ -630,20 +2182,8 @@ class Thread {
              typename A6, typename A7, typename A8, typename A9>
     void start(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9), A1 a1,
                A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>* pThreadData =
-            new ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>(
-                pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9));
     }
 
   private:
@@ -678,17 +2218,6 @@ class Thread {
         A9 a9_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5,
-             typename A6, typename A7, typename A8, typename A9>
-    static void* startThreadStatic9(void* data) {
-        ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>* pThreadData =
-            reinterpret_cast<
-                ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8, A9>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename A1, typename A2, typename A3, typename A4, typename A5,
              typename A6, typename A7, typename A8, typename A9, typename A10>
@@ -696,7 +2225,12 @@ class Thread {
            A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
     }
 
@@ -705,21 +2239,8 @@ class Thread {
     void start(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10),
                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
                A10 a10) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*
-            pThreadData =
-                new ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>(
-                    pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
     }
 
   private:
@@ -757,40 +2278,23 @@ class Thread {
         A10 a10_;
     };
 
-    template<typename A1, typename A2, typename A3, typename A4, typename A5,
-             typename A6, typename A7, typename A8, typename A9, typename A10>
-    static void* startThreadStatic10(void* data) {
-        ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*
-            pThreadData = reinterpret_cast<
-                ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class>
     Thread(void (Class::*pFunction)(), Class* pObject) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject);
     }
 
     template<typename Class>
     void start(void (Class::*pFunction)(), Class* pObject) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod0<Class>* pThreadData =
-            new ThreadDataMethod0<Class>(pFunction, pObject);
-        int result = ::pthread_create(&id_, attr_, &startThreadMethod0<Class>,
-                                      pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod0<Class>(pFunction, pObject));
     }
 
   private:
@@ -806,37 +2310,23 @@ class Thread {
         Class* pObject_;
     };
 
-    template<typename Class>
-    static void* startThreadMethod0(void* data) {
-        ThreadDataMethod0<Class>* pThreadData =
-            reinterpret_cast<ThreadDataMethod0<Class>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1>
     Thread(void (Class::*pFunction)(A1), Class* pObject, A1 a1) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1);
     }
 
     template<typename Class, typename A1>
     void start(void (Class::*pFunction)(A1), Class* pObject, A1 a1) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod1<Class, A1>* pThreadData =
-            new ThreadDataMethod1<Class, A1>(pFunction, pObject, a1);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod1<Class, A1>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod1<Class, A1>(pFunction, pObject, a1));
     }
 
   private:
@@ -854,37 +2344,23 @@ class Thread {
         A1 a1_;
     };
 
-    template<typename Class, typename A1>
-    static void* startThreadMethod1(void* data) {
-        ThreadDataMethod1<Class, A1>* pThreadData =
-            reinterpret_cast<ThreadDataMethod1<Class, A1>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2>
     Thread(void (Class::*pFunction)(A1, A2), Class* pObject, A1 a1, A2 a2) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2);
     }
 
     template<typename Class, typename A1, typename A2>
     void start(void (Class::*pFunction)(A1, A2), Class* pObject, A1 a1, A2 a2) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod2<Class, A1, A2>* pThreadData =
-            new ThreadDataMethod2<Class, A1, A2>(pFunction, pObject, a1, a2);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod2<Class, A1, A2>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod2<Class, A1, A2>(pFunction, pObject, a1, a2));
     }
 
   private:
@@ -905,40 +2381,26 @@ class Thread {
         A2 a2_;
     };
 
-    template<typename Class, typename A1, typename A2>
-    static void* startThreadMethod2(void* data) {
-        ThreadDataMethod2<Class, A1, A2>* pThreadData =
-            reinterpret_cast<ThreadDataMethod2<Class, A1, A2>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3>
     Thread(void (Class::*pFunction)(A1, A2, A3), Class* pObject, A1 a1, A2 a2,
            A3 a3) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3);
     }
 
     template<typename Class, typename A1, typename A2, typename A3>
     void start(void (Class::*pFunction)(A1, A2, A3), Class* pObject, A1 a1,
                A2 a2, A3 a3) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod3<Class, A1, A2, A3>* pThreadData =
-            new ThreadDataMethod3<Class, A1, A2, A3>(pFunction, pObject, a1, a2,
-                                                     a3);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod3<Class, A1, A2, A3>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod3<Class, A1, A2, A3>(
+            pFunction, pObject, a1, a2, a3));
     }
 
   private:
@@ -961,41 +2423,26 @@ class Thread {
         A3 a3_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3>
-    static void* startThreadMethod3(void* data) {
-        ThreadDataMethod3<Class, A1, A2, A3>* pThreadData =
-            reinterpret_cast<ThreadDataMethod3<Class, A1, A2, A3>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4>
     Thread(void (Class::*pFunction)(A1, A2, A3, A4), Class* pObject, A1 a1,
            A2 a2, A3 a3, A4 a4) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4);
     }
 
     template<typename Class, typename A1, typename A2, typename A3, typename A4>
     void start(void (Class::*pFunction)(A1, A2, A3, A4), Class* pObject, A1 a1,
                A2 a2, A3 a3, A4 a4) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod4<Class, A1, A2, A3, A4>* pThreadData =
-            new ThreadDataMethod4<Class, A1, A2, A3, A4>(pFunction, pObject, a1,
-                                                         a2, a3, a4);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod4<Class, A1, A2, A3, A4>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod4<Class, A1, A2, A3, A4>(
+            pFunction, pObject, a1, a2, a3, a4));
     }
 
   private:
@@ -1020,15 +2467,6 @@ class Thread {
         A4 a4_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4>
-    static void* startThreadMethod4(void* data) {
-        ThreadDataMethod4<Class, A1, A2, A3, A4>* pThreadData =
-            reinterpret_cast<ThreadDataMethod4<Class, A1, A2, A3, A4>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5>
@@ -1036,7 +2474,12 @@ class Thread {
            A2 a2, A3 a3, A4 a4, A5 a5) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5);
     }
 
@@ -1044,19 +2487,8 @@ class Thread {
              typename A5>
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5), Class* pObject,
                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod5<Class, A1, A2, A3, A4, A5>* pThreadData =
-            new ThreadDataMethod5<Class, A1, A2, A3, A4, A5>(
-                pFunction, pObject, a1, a2, a3, a4, a5);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod5<Class, A1, A2, A3, A4, A5>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod5<Class, A1, A2, A3, A4, A5>(
+            pFunction, pObject, a1, a2, a3, a4, a5));
     }
 
   private:
@@ -1084,17 +2516,6 @@ class Thread {
         A5 a5_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5>
-    static void* startThreadMethod5(void* data) {
-        ThreadDataMethod5<Class, A1, A2, A3, A4, A5>* pThreadData =
-            reinterpret_cast<ThreadDataMethod5<Class, A1, A2, A3, A4, A5>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6>
@@ -1102,7 +2523,12 @@ class Thread {
            A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6);
     }
 
@@ -1110,19 +2536,8 @@ class Thread {
              typename A5, typename A6>
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6), Class* pObject,
                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>* pThreadData =
-            new ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod6<Class, A1, A2, A3, A4, A5, A6>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6));
     }
 
   private:
@@ -1153,17 +2568,6 @@ class Thread {
         A6 a6_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6>
-    static void* startThreadMethod6(void* data) {
-        ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>* pThreadData =
-            reinterpret_cast<ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7>
@@ -1171,7 +2575,12 @@ class Thread {
            A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7);
     }
 
@@ -1180,19 +2589,8 @@ class Thread {
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7),
                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
                A7 a7) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            new ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethod7<Class, A1, A2, A3, A4, A5, A6, A7>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
     }
 
   private:
@@ -1225,17 +2623,6 @@ class Thread {
         A7 a7_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7>
-    static void* startThreadMethod7(void* data) {
-        ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            reinterpret_cast<
-                ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8>
@@ -1244,7 +2631,12 @@ class Thread {
            A8 a8) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8);
     }
 
@@ -1253,20 +2645,8 @@ class Thread {
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8),
                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
                A8 a8) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>* pThreadData =
-            new ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
     }
 
   private:
@@ -1302,18 +2682,6 @@ class Thread {
         A8 a8_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7, typename A8>
-    static void* startThreadMethod8(void* data) {
-        ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>* pThreadData =
-            reinterpret_cast<
-                ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7, A8>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9>
@@ -1322,30 +2690,22 @@ class Thread {
            A8 a8, A9 a9) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9);
     }
 
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9>
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9),
-               Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
-               A8 a8, A9 a9) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8,
-                          A9>* pThreadData =
-            new ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+               Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+               A8 a8, A9 a9) {
+        create(ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
     }
 
   private:
@@ -1384,18 +2744,6 @@ class Thread {
         A9 a9_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7, typename A8, typename A9>
-    static void* startThreadMethod9(void* data) {
-        ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>*
-            pThreadData = reinterpret_cast<
-                ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9,
@@ -1405,7 +2753,12 @@ class Thread {
            A8 a8, A9 a9, A10 a10) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
     }
 
@@ -1416,22 +2769,9 @@ class Thread {
                                         A10),
                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
                A8 a8, A9 a9, A10 a10) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*
-            pThreadData = new ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6,
-                                                 A7, A8, A9, A10>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
-        int result =
-            ::pthread_create(&id_, attr_,
-                             &startThreadMethod10<Class, A1, A2, A3, A4, A5, A6,
-                                                  A7, A8, A9, A10>,
-                             pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9,
+                                  A10>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
     }
 
   private:
@@ -1473,41 +2813,23 @@ class Thread {
         A10 a10_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7, typename A8, typename A9,
-             typename A10>
-    static void* startThreadMethod10(void* data) {
-        ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9,
-                           A10>* pThreadData =
-            reinterpret_cast<ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6,
-                                                A7, A8, A9, A10>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class>
     Thread(void (Class::*pFunction)() const, const Class* pObject) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject);
     }
 
     template<typename Class>
     void start(void (Class::*pFunction)() const, const Class* pObject) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst0<Class>* pThreadData =
-            new ThreadDataMethodConst0<Class>(pFunction, pObject);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst0<Class>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst0<Class>(pFunction, pObject));
     }
 
   private:
@@ -1524,38 +2846,24 @@ class Thread {
         const Class* pObject_;
     };
 
-    template<typename Class>
-    static void* startThreadMethodConst0(void* data) {
-        ThreadDataMethodConst0<Class>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst0<Class>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1>
     Thread(void (Class::*pFunction)(A1) const, const Class* pObject, A1 a1) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1);
     }
 
     template<typename Class, typename A1>
     void start(void (Class::*pFunction)(A1) const, const Class* pObject,
                A1 a1) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst1<Class, A1>* pThreadData =
-            new ThreadDataMethodConst1<Class, A1>(pFunction, pObject, a1);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst1<Class, A1>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst1<Class, A1>(pFunction, pObject, a1));
     }
 
   private:
@@ -1574,40 +2882,26 @@ class Thread {
         A1 a1_;
     };
 
-    template<typename Class, typename A1>
-    static void* startThreadMethodConst1(void* data) {
-        ThreadDataMethodConst1<Class, A1>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst1<Class, A1>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2>
     Thread(void (Class::*pFunction)(A1, A2) const, const Class* pObject, A1 a1,
            A2 a2) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2);
     }
 
     template<typename Class, typename A1, typename A2>
     void start(void (Class::*pFunction)(A1, A2) const, const Class* pObject,
                A1 a1, A2 a2) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst2<Class, A1, A2>* pThreadData =
-            new ThreadDataMethodConst2<Class, A1, A2>(pFunction, pObject, a1,
-                                                      a2);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst2<Class, A1, A2>, pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst2<Class, A1, A2>(
+            pFunction, pObject, a1, a2));
     }
 
   private:
@@ -1628,41 +2922,26 @@ class Thread {
         A2 a2_;
     };
 
-    template<typename Class, typename A1, typename A2>
-    static void* startThreadMethodConst2(void* data) {
-        ThreadDataMethodConst2<Class, A1, A2>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst2<Class, A1, A2>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3>
     Thread(void (Class::*pFunction)(A1, A2, A3) const, const Class* pObject,
            A1 a1, A2 a2, A3 a3) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3);
     }
 
     template<typename Class, typename A1, typename A2, typename A3>
     void start(void (Class::*pFunction)(A1, A2, A3) const, const Class* pObject,
                A1 a1, A2 a2, A3 a3) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst3<Class, A1, A2, A3>* pThreadData =
-            new ThreadDataMethodConst3<Class, A1, A2, A3>(pFunction, pObject,
-                                                          a1, a2, a3);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst3<Class, A1, A2, A3>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst3<Class, A1, A2, A3>(
+            pFunction, pObject, a1, a2, a3));
     }
 
   private:
@@ -1685,41 +2964,26 @@ class Thread {
         A3 a3_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3>
-    static void* startThreadMethodConst3(void* data) {
-        ThreadDataMethodConst3<Class, A1, A2, A3>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst3<Class, A1, A2, A3>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4>
     Thread(void (Class::*pFunction)(A1, A2, A3, A4) const, const Class* pObject,
            A1 a1, A2 a2, A3 a3, A4 a4) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4);
     }
 
     template<typename Class, typename A1, typename A2, typename A3, typename A4>
     void start(void (Class::*pFunction)(A1, A2, A3, A4) const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst4<Class, A1, A2, A3, A4>* pThreadData =
-            new ThreadDataMethodConst4<Class, A1, A2, A3, A4>(
-                pFunction, pObject, a1, a2, a3, a4);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst4<Class, A1, A2, A3, A4>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst4<Class, A1, A2, A3, A4>(
+            pFunction, pObject, a1, a2, a3, a4));
     }
 
   private:
@@ -1745,16 +3009,6 @@ class Thread {
         A4 a4_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4>
-    static void* startThreadMethodConst4(void* data) {
-        ThreadDataMethodConst4<Class, A1, A2, A3, A4>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst4<Class, A1, A2, A3, A4>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5>
@@ -1762,7 +3016,12 @@ class Thread {
            const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5);
     }
 
@@ -1770,19 +3029,8 @@ class Thread {
              typename A5>
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5) const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>* pThreadData =
-            new ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>(
-                pFunction, pObject, a1, a2, a3, a4, a5);
-        int result = ::pthread_create(
-            &id_, attr_, &startThreadMethodConst5<Class, A1, A2, A3, A4, A5>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>(
+            pFunction, pObject, a1, a2, a3, a4, a5));
     }
 
   private:
@@ -1812,17 +3060,6 @@ class Thread {
         A5 a5_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5>
-    static void* startThreadMethodConst5(void* data) {
-        ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>* pThreadData =
-            reinterpret_cast<
-                ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6>
@@ -1830,7 +3067,12 @@ class Thread {
            const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6);
     }
 
@@ -1838,20 +3080,8 @@ class Thread {
              typename A5, typename A6>
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6) const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5, A6>* pThreadData =
-            new ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5, A6>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethodConst6<Class, A1, A2, A3, A4, A5, A6>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5, A6>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6));
     }
 
   private:
@@ -1883,17 +3113,6 @@ class Thread {
         A6 a6_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6>
-    static void* startThreadMethodConst6(void* data) {
-        ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5, A6>* pThreadData =
-            reinterpret_cast<
-                ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5, A6>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7>
@@ -1902,7 +3121,12 @@ class Thread {
            A7 a7) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7);
     }
 
@@ -1911,20 +3135,8 @@ class Thread {
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7) const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
                A7 a7) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            new ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
     }
 
   private:
@@ -1958,18 +3170,6 @@ class Thread {
         A7 a7_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7>
-    static void* startThreadMethodConst7(void* data) {
-        ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>* pThreadData =
-            reinterpret_cast<
-                ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6, A7>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8>
@@ -1978,7 +3178,12 @@ class Thread {
            A7 a7, A8 a8) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8);
     }
 
@@ -1987,21 +3192,8 @@ class Thread {
     void start(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8) const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
                A7 a7, A8 a8) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7,
-                               A8>* pThreadData =
-            new ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7, A8>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7, A8>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7, A8>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
     }
 
   private:
@@ -2037,18 +3229,6 @@ class Thread {
         A8 a8_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7, typename A8>
-    static void* startThreadMethodConst8(void* data) {
-        ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7, A8>*
-            pThreadData = reinterpret_cast<
-                ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6, A7, A8>*>(
-                data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9>
@@ -2057,7 +3237,12 @@ class Thread {
            A7 a7, A8 a8, A9 a9) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9);
     }
 
@@ -2067,21 +3252,9 @@ class Thread {
                    const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
                A7 a7, A8 a8, A9 a9) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>*
-            pThreadData = new ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5,
-                                                     A6, A7, A8, A9>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9);
-        int result = ::pthread_create(
-            &id_, attr_,
-            &startThreadMethodConst9<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9>,
-            pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5, A6, A7, A8,
+                                      A9>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
     }
 
   private:
@@ -2120,18 +3293,6 @@ class Thread {
         A9 a9_;
     };
 
-    template<typename Class, typename A1, typename A2, typename A3, typename A4,
-             typename A5, typename A6, typename A7, typename A8, typename A9>
-    static void* startThreadMethodConst9(void* data) {
-        ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5, A6, A7, A8,
-                               A9>* pThreadData =
-            reinterpret_cast<ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5,
-                                                    A6, A7, A8, A9>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
-    }
-
   public:
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9,
@@ -2142,7 +3303,12 @@ class Thread {
            A7 a7, A8 a8, A9 a9, A10 a10) :
         id_(0),
         isDetached_(false),
-        attr_(NULL) {
+        attr_(NULL),
+        isReaped_(false),
+        isPersistent_(false),
+        jobState_(JOB_IDLE),
+        pState_(NULL),
+        isStarted_(START_DONE) {
         start(pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
     }
 
@@ -2153,22 +3319,9 @@ class Thread {
                    const,
                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
                A7 a7, A8 a8, A9 a9, A10 a10) {
-        if (id_ != 0) {
-            throw Exception(id_, "Thread already started");
-        }
-        ThreadDataMethodConst10<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*
-            pThreadData = new ThreadDataMethodConst10<Class, A1, A2, A3, A4, A5,
-                                                      A6, A7, A8, A9, A10>(
-                pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
-        int result =
-            ::pthread_create(&id_, attr_,
-                             &startThreadMethodConst10<Class, A1, A2, A3, A4,
-                                                       A5, A6, A7, A8, A9, A10>,
-                             pThreadData);
-        if (result != 0) {
-            delete pThreadData;
-            throw Exception(id_, "Failed to create thread");
-        }
+        create(ThreadDataMethodConst10<Class, A1, A2, A3, A4, A5, A6, A7, A8,
+                                       A9, A10>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
     }
 
   private:
@@ -2211,18 +3364,581 @@ class Thread {
         A9 a9_;
         A10 a10_;
     };
+};
+
+inline void CapturedException::rethrow() const {
+#if __cplusplus >= 201103L
+    std::rethrow_exception(exception_);
+#else
+    throw Thread::UncaughtException(id_, what_);
+#endif
+}
+
+/**
+ * Base of the executors, builds a Task from any bound call accepted by
+ * Thread::start and hands it to Derived::push(const Task&).
+ */
+template<typename Derived>
+class Executor {
+  public:
+    void submit(void (*pFunction)()) {
+        submitTask(Thread::ThreadDataStatic0(pFunction));
+    }
+
+    template<typename A1>
+    void submit(void (*pFunction)(A1), A1 a1) {
+        submitTask(Thread::ThreadDataStatic1<A1>(pFunction, a1));
+    }
+
+    template<typename A1, typename A2>
+    void submit(void (*pFunction)(A1, A2), A1 a1, A2 a2) {
+        submitTask(Thread::ThreadDataStatic2<A1, A2>(pFunction, a1, a2));
+    }
+
+    template<typename A1, typename A2, typename A3>
+    void submit(void (*pFunction)(A1, A2, A3), A1 a1, A2 a2, A3 a3) {
+        submitTask(Thread::ThreadDataStatic3<A1, A2, A3>(
+            pFunction, a1, a2, a3));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4>
+    void submit(void (*pFunction)(A1, A2, A3, A4), A1 a1, A2 a2, A3 a3, A4 a4) {
+        submitTask(Thread::ThreadDataStatic4<A1, A2, A3, A4>(
+            pFunction, a1, a2, a3, a4));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5), A1 a1, A2 a2, A3 a3,
+                A4 a4, A5 a5) {
+        submitTask(Thread::ThreadDataStatic5<A1, A2, A3, A4, A5>(
+            pFunction, a1, a2, a3, a4, a5));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5,
+             typename A6>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5, A6), A1 a1, A2 a2, A3 a3,
+                A4 a4, A5 a5, A6 a6) {
+        submitTask(Thread::ThreadDataStatic6<A1, A2, A3, A4, A5, A6>(
+            pFunction, a1, a2, a3, a4, a5, a6));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5,
+             typename A6, typename A7>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7), A1 a1, A2 a2,
+                A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) {
+        submitTask(Thread::ThreadDataStatic7<A1, A2, A3, A4, A5, A6, A7>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5,
+             typename A6, typename A7, typename A8>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8), A1 a1, A2 a2,
+                A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) {
+        submitTask(Thread::ThreadDataStatic8<A1, A2, A3, A4, A5, A6, A7, A8>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5,
+             typename A6, typename A7, typename A8, typename A9>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9), A1 a1,
+                A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) {
+        submitTask(Thread::ThreadDataStatic9<A1, A2, A3, A4, A5, A6, A7, A8,
+                                             A9>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5,
+             typename A6, typename A7, typename A8, typename A9, typename A10>
+    void submit(void (*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10),
+                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
+                A10 a10) {
+        submitTask(Thread::ThreadDataStatic10<A1, A2, A3, A4, A5, A6, A7, A8,
+                                              A9, A10>(
+            pFunction, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+    }
+
+    template<typename Class>
+    void submit(void (Class::*pFunction)(), Class* pObject) {
+        submitTask(Thread::ThreadDataMethod0<Class>(pFunction, pObject));
+    }
+
+    template<typename Class, typename A1>
+    void submit(void (Class::*pFunction)(A1), Class* pObject, A1 a1) {
+        submitTask(Thread::ThreadDataMethod1<Class, A1>(
+            pFunction, pObject, a1));
+    }
+
+    template<typename Class, typename A1, typename A2>
+    void submit(void (Class::*pFunction)(A1, A2), Class* pObject, A1 a1,
+                A2 a2) {
+        submitTask(Thread::ThreadDataMethod2<Class, A1, A2>(
+            pFunction, pObject, a1, a2));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3>
+    void submit(void (Class::*pFunction)(A1, A2, A3), Class* pObject, A1 a1,
+                A2 a2, A3 a3) {
+        submitTask(Thread::ThreadDataMethod3<Class, A1, A2, A3>(
+            pFunction, pObject, a1, a2, a3));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4), Class* pObject, A1 a1,
+                A2 a2, A3 a3, A4 a4) {
+        submitTask(Thread::ThreadDataMethod4<Class, A1, A2, A3, A4>(
+            pFunction, pObject, a1, a2, a3, a4));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5), Class* pObject,
+                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
+        submitTask(Thread::ThreadDataMethod5<Class, A1, A2, A3, A4, A5>(
+            pFunction, pObject, a1, a2, a3, a4, a5));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) {
+        submitTask(Thread::ThreadDataMethod6<Class, A1, A2, A3, A4, A5, A6>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7) {
+        submitTask(Thread::ThreadDataMethod7<Class, A1, A2, A3, A4, A5, A6, A7>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7, typename A8>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8) {
+        submitTask(Thread::ThreadDataMethod8<Class, A1, A2, A3, A4, A5, A6, A7,
+                                             A8>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7, typename A8, typename A9>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8, A9 a9) {
+        submitTask(Thread::ThreadDataMethod9<Class, A1, A2, A3, A4, A5, A6, A7,
+                                             A8, A9>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
 
     template<typename Class, typename A1, typename A2, typename A3, typename A4,
              typename A5, typename A6, typename A7, typename A8, typename A9,
              typename A10>
-    static void* startThreadMethodConst10(void* data) {
-        ThreadDataMethodConst10<Class, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*
-            pThreadData = reinterpret_cast<ThreadDataMethodConst10<
-                Class, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10>*>(data);
-        pThreadData->call();
-        delete pThreadData;
-        return NULL;
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9,
+                                         A10),
+                Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7,
+                A8 a8, A9 a9, A10 a10) {
+        submitTask(Thread::ThreadDataMethod10<Class, A1, A2, A3, A4, A5, A6, A7,
+                                              A8, A9, A10>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+    }
+
+    template<typename Class>
+    void submit(void (Class::*pFunction)() const, const Class* pObject) {
+        submitTask(Thread::ThreadDataMethodConst0<Class>(pFunction, pObject));
+    }
+
+    template<typename Class, typename A1>
+    void submit(void (Class::*pFunction)(A1) const, const Class* pObject,
+                A1 a1) {
+        submitTask(Thread::ThreadDataMethodConst1<Class, A1>(
+            pFunction, pObject, a1));
+    }
+
+    template<typename Class, typename A1, typename A2>
+    void submit(void (Class::*pFunction)(A1, A2) const, const Class* pObject,
+                A1 a1, A2 a2) {
+        submitTask(Thread::ThreadDataMethodConst2<Class, A1, A2>(
+            pFunction, pObject, a1, a2));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3>
+    void submit(void (Class::*pFunction)(A1, A2, A3) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3) {
+        submitTask(Thread::ThreadDataMethodConst3<Class, A1, A2, A3>(
+            pFunction, pObject, a1, a2, a3));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4) {
+        submitTask(Thread::ThreadDataMethodConst4<Class, A1, A2, A3, A4>(
+            pFunction, pObject, a1, a2, a3, a4));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
+        submitTask(Thread::ThreadDataMethodConst5<Class, A1, A2, A3, A4, A5>(
+            pFunction, pObject, a1, a2, a3, a4, a5));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5,
+                A6 a6) {
+        submitTask(Thread::ThreadDataMethodConst6<Class, A1, A2, A3, A4, A5,
+                                                  A6>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7) {
+        submitTask(Thread::ThreadDataMethodConst7<Class, A1, A2, A3, A4, A5, A6,
+                                                  A7>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7, typename A8>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8) const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7, A8 a8) {
+        submitTask(Thread::ThreadDataMethodConst8<Class, A1, A2, A3, A4, A5, A6,
+                                                  A7, A8>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7, typename A8, typename A9>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9)
+                    const,
+                const Class* pObject, A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6,
+                A7 a7, A8 a8, A9 a9) {
+        submitTask(Thread::ThreadDataMethodConst9<Class, A1, A2, A3, A4, A5, A6,
+                                                  A7, A8, A9>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9));
+    }
+
+    template<typename Class, typename A1, typename A2, typename A3, typename A4,
+             typename A5, typename A6, typename A7, typename A8, typename A9,
+             typename A10>
+    void submit(void (Class::*pFunction)(A1, A2, A3, A4, A5, A6, A7, A8, A9,
+                                         A10) const, const Class* pObject,
+                A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
+                A10 a10) {
+        submitTask(Thread::ThreadDataMethodConst10<Class, A1, A2, A3, A4, A5,
+                                                   A6, A7, A8, A9, A10>(
+            pFunction, pObject, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
+    }
+
+  private:
+    template<typename T>
+    void submitTask(const T& threadData) {
+        static_cast<Derived*>(this)->push(Task::create(threadData));
+    }
+};
+
+/**
+ * Base of the pools of Thread workers: tells wait when every submitted call
+ * has returned, keeps the first exception and parks the idle workers.
+ * Each worker counts the calls it queues and runs in its own WorkerState,
+ * only wait sums them. The Task a worker creates and runs come from its
+ * ThreadDataPool::LocalCache.
+ * Derived::hasTask() const tells a parking worker that a call is queued,
+ * Derived::findTask(pWorker, task) takes one for runWorker and
+ * Derived::worker(index) const returns the WorkerState of each of the
+ * Derived::size() workers.
+ */
+template<typename Derived>
+class PoolExecutor : public Executor<Derived> {
+  public:
+    /**
+     * Wait until every submitted call has returned.
+     * Rethrow the first exception that escaped a call since the previous
+     * wait, the others are dropped.
+     * Must not be called from a worker.
+     */
+    void wait() {
+        ::pthread_mutex_lock(&sleepMutex_);
+        __atomic_add_fetch(&waiters_, 1, __ATOMIC_RELAXED);
+        // pairs with the fence of notifyIdle
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (!isIdle()) {
+            ::pthread_cond_wait(&idle_, &sleepMutex_);
+        }
+        __atomic_sub_fetch(&waiters_, 1, __ATOMIC_RELAXED);
+        CapturedException* pException = pException_;
+        pException_ = NULL;
+        ::pthread_mutex_unlock(&sleepMutex_);
+        if (pException != NULL) {
+            try {
+                pException->rethrow();
+            }
+            catch (...) {
+                delete pException;
+                throw;
+            }
+        }
+    }
+
+  protected:
+    // only written by its worker
+    struct WorkerState {
+        WorkerState() :
+            pPool(NULL),
+            submitted(0),
+            completed(0) {}
+        PoolExecutor* pPool;
+        // calls queued by the worker
+        unsigned long submitted;
+        // calls run by the worker
+        unsigned long completed;
+        ThreadDataPool::LocalCache cache;
+    };
+
+    // workers parked on the same condition
+    struct Sleepers {
+        Sleepers() :
+            count(0) {
+            ::pthread_cond_init(&wakeUp, NULL);
+        }
+        ~Sleepers() {
+            ::pthread_cond_destroy(&wakeUp);
+        }
+        // protected by the sleep mutex of the pool
+        std::size_t count;
+        ::pthread_cond_t wakeUp;
+    };
+
+    PoolExecutor() :
+        submitted_(0),
+        waiters_(0),
+        sleeperCount_(0),
+        pException_(NULL),
+        isStopped_(false) {
+        ::pthread_mutex_init(&sleepMutex_, NULL);
+        ::pthread_cond_init(&idle_, NULL);
+    }
+
+    // the workers are joined by Derived
+    ~PoolExecutor() {
+        delete pException_;
+        ::pthread_cond_destroy(&idle_);
+        ::pthread_mutex_destroy(&sleepMutex_);
+    }
+
+    // counters are only written by their worker
+    static void increment(unsigned long& counter) {
+        unsigned long value = __atomic_load_n(&counter, __ATOMIC_RELAXED);
+        __atomic_store_n(&counter, value + 1, __ATOMIC_RELAXED);
+    }
+
+    // worker running the calling thread, NULL outside of the workers
+    static WorkerState*& currentWorker() {
+        static __thread WorkerState* pWorker = NULL;
+        return pWorker;
+    }
+
+    // worker of this pool running the calling thread, NULL otherwise
+    WorkerState* callerWorker() const {
+        WorkerState* pWorker = currentWorker();
+        return pWorker != NULL && pWorker->pPool == this ? pWorker : NULL;
+    }
+
+    // before a call is queued
+    void addPending() {
+        WorkerState* pWorker = callerWorker();
+        if (pWorker != NULL) {
+            increment(pWorker->submitted);
+        }
+        else {
+            __atomic_add_fetch(&submitted_, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    // the call could not be queued
+    void removePending() {
+        WorkerState* pWorker = callerWorker();
+        if (pWorker != NULL) {
+            __atomic_store_n(&pWorker->submitted, pWorker->submitted - 1,
+                             __ATOMIC_RELAXED);
+        }
+        else {
+            __atomic_sub_fetch(&submitted_, 1, __ATOMIC_RELAXED);
+        }
+        notifyIdle();
+    }
+
+    /**
+     * Run the calls found by Derived::findTask, spinning a little before
+     * parking on sleepers, until the pool is stopped and nothing is left.
+     */
+    template<typename Worker>
+    void runWorker(Worker* pWorker, Sleepers& sleepers) {
+        Derived* pDerived = static_cast<Derived*>(this);
+        pWorker->pPool = this;
+        currentWorker() = pWorker;
+        ThreadDataPool::set_local_cache(&pWorker->cache);
+        Task task;
+        bool hasRun = false;
+        for (;;) {
+            bool isFound = pDerived->findTask(pWorker, task);
+            if (!isFound && hasRun) {
+                // the calls just run may be the last ones wait waits for
+                notifyIdle();
+                hasRun = false;
+            }
+            for (int i = 1; i < SPIN_COUNT && !isFound; ++i) {
+                ::sched_yield();
+                isFound = pDerived->findTask(pWorker, task);
+            }
+            if (isFound) {
+                runTask(pWorker, task);
+                hasRun = true;
+            }
+            else if (!sleep(sleepers)) {
+                break;
+            }
+        }
+        ThreadDataPool::set_local_cache(NULL);
+        currentWorker() = NULL;
+    }
+
+    /**
+     * Wake a worker parked on pSleepers[first], else on the next ones, once
+     * a call is queued.
+     * Only takes the sleep mutex when a worker is parked.
+     */
+    void wake(Sleepers* pSleepers, std::size_t count, std::size_t first) {
+        // pairs with the fence of a worker going to sleep
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&sleeperCount_, __ATOMIC_RELAXED) == 0) {
+            return;
+        }
+        ::pthread_mutex_lock(&sleepMutex_);
+        std::size_t i = 0;
+        while (i < count && pSleepers[(first + i) % count].count == 0) {
+            ++i;
+        }
+        if (i < count) {
+            ::pthread_cond_signal(&pSleepers[(first + i) % count].wakeUp);
+        }
+        ::pthread_mutex_unlock(&sleepMutex_);
+    }
+
+    /**
+     * The workers return once nothing is left to run, Derived joins them.
+     */
+    void stopWorkers(Sleepers* pSleepers, std::size_t count) {
+        ::pthread_mutex_lock(&sleepMutex_);
+        isStopped_ = true;
+        for (std::size_t i = 0; i < count; ++i) {
+            ::pthread_cond_broadcast(&pSleepers[i].wakeUp);
+        }
+        ::pthread_mutex_unlock(&sleepMutex_);
     }
+
+  private:
+    PoolExecutor(const PoolExecutor&);
+    PoolExecutor& operator=(const PoolExecutor&);
+
+    enum {
+        // find attempts before a worker parks
+        SPIN_COUNT = 64
+    };
+
+    void runTask(WorkerState* pWorker, Task& task) {
+        CapturedException* pException = task.run();
+        if (pException != NULL) {
+            keepException(pException);
+        }
+        // publishes the calls queued by the call to wait
+        __atomic_store_n(&pWorker->completed, pWorker->completed + 1,
+                         __ATOMIC_RELEASE);
+    }
+
+    void keepException(CapturedException* pException) {
+        ::pthread_mutex_lock(&sleepMutex_);
+        if (pException_ == NULL) {
+            pException_ = pException;
+        }
+        else {
+            delete pException;
+        }
+        ::pthread_mutex_unlock(&sleepMutex_);
+    }
+
+    /**
+     * Every submitted call has returned.
+     * The completed counts are read first: a call seen completed had queued
+     * its own calls before, so they are seen submitted.
+     */
+    bool isIdle() const {
+        const Derived* pDerived = static_cast<const Derived*>(this);
+        std::size_t size = pDerived->size();
+        unsigned long completed = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const WorkerState& worker = pDerived->worker(i);
+            completed += __atomic_load_n(&worker.completed, __ATOMIC_ACQUIRE);
+        }
+        unsigned long submitted =
+            __atomic_load_n(&submitted_, __ATOMIC_RELAXED);
+        for (std::size_t i = 0; i < size; ++i) {
+            const WorkerState& worker = pDerived->worker(i);
+            submitted += __atomic_load_n(&worker.submitted, __ATOMIC_RELAXED);
+        }
+        return submitted == completed;
+    }
+
+    // only takes the sleep mutex when wait is waiting
+    void notifyIdle() {
+        // pairs with the fence of wait
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&waiters_, __ATOMIC_RELAXED) != 0) {
+            ::pthread_mutex_lock(&sleepMutex_);
+            ::pthread_cond_broadcast(&idle_);
+            ::pthread_mutex_unlock(&sleepMutex_);
+        }
+    }
+
+    /**
+     * Park until Derived::hasTask.
+     * Return false when the pool is stopped and nothing is left to run.
+     */
+    bool sleep(Sleepers& sleepers) {
+        const Derived* pDerived = static_cast<const Derived*>(this);
+        ::pthread_mutex_lock(&sleepMutex_);
+        ++sleepers.count;
+        __atomic_add_fetch(&sleeperCount_, 1, __ATOMIC_SEQ_CST);
+        // pairs with the fence of wake
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (!pDerived->hasTask() && !isStopped_) {
+            ::pthread_cond_wait(&sleepers.wakeUp, &sleepMutex_);
+        }
+        __atomic_sub_fetch(&sleeperCount_, 1, __ATOMIC_SEQ_CST);
+        --sleepers.count;
+        bool isRunning = !isStopped_ || pDerived->hasTask();
+        ::pthread_mutex_unlock(&sleepMutex_);
+        return isRunning;
+    }
+
+    // calls queued from outside of the workers
+    unsigned long submitted_;
+    std::size_t waiters_;
+    std::size_t sleeperCount_;
+    CapturedException* pException_;
+    bool isStopped_;
+    ::pthread_mutex_t sleepMutex_;
+    ::pthread_cond_t idle_;
 };
 
 } // namespace blet
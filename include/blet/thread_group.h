@@ -0,0 +1,214 @@
+/**
+ * thread_group.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_THREAD_GROUP_H_
+#define BLET_THREAD_GROUP_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Threads started together for a fan-out/fan-in.
+ * Each submit creates one thread with the shared Attributes, held at a start
+ * barrier until release.
+ * release opens the barrier for every member with a single futex wake, join
+ * waits on a single countdown reaching 0 instead of joining each thread.
+ * The finished threads are reaped by the next submit or the destructor, off
+ * the path of join.
+ */
+class ThreadGroup : public Executor<ThreadGroup> {
+  public:
+    /**
+     * The detached attribute is ignored, members are reaped by the group.
+     * The completion fd is signaled once the last member of a batch returns.
+     */
+    explicit ThreadGroup(
+        const Thread::Attributes& attributes = Thread::Attributes()) :
+        attributes_(attributes),
+        isJoined_(false),
+        released_(0),
+        remaining_(0),
+        pException_(NULL) {
+        attributes_.set_detached(false);
+    }
+
+    /**
+     * Release and wait for the members still running, their exceptions are
+     * dropped.
+     */
+    ~ThreadGroup() {
+        try {
+            join();
+        }
+        catch (...) {
+        }
+        reap();
+    }
+
+    /**
+     * Number of threads since the last join.
+     */
+    std::size_t size() const {
+        return isJoined_ ? 0 : threads_.size();
+    }
+
+    /**
+     * Let every member waiting at the start barrier run.
+     * Members submitted after it, until the next join, run at once.
+     */
+    void release() {
+        __atomic_store_n(&released_, 1, __ATOMIC_RELEASE);
+        Thread::futexWake(&released_);
+    }
+
+    /**
+     * Release the members then wait until all of them have returned.
+     * Rethrow the first exception that escaped a member, the others are
+     * dropped.
+     * The next submit starts a new batch.
+     */
+    void join() {
+        release();
+        int remaining = __atomic_load_n(&remaining_, __ATOMIC_ACQUIRE);
+        while (remaining != 0) {
+            Thread::futexWait(&remaining_, remaining);
+            remaining = __atomic_load_n(&remaining_, __ATOMIC_ACQUIRE);
+        }
+        isJoined_ = true;
+        CapturedException* pException = __atomic_exchange_n(
+            &pException_, static_cast<CapturedException*>(NULL),
+            __ATOMIC_ACQUIRE);
+        if (pException != NULL) {
+            try {
+                pException->rethrow();
+            }
+            catch (...) {
+                delete pException;
+                throw;
+            }
+        }
+    }
+
+  private:
+    friend class Executor<ThreadGroup>;
+
+    ThreadGroup(const ThreadGroup&);
+    ThreadGroup& operator=(const ThreadGroup&);
+
+    struct Member {
+        ThreadGroup* pGroup;
+        Task task;
+    };
+
+    void push(const Task& task) {
+        if (isJoined_) {
+            // members of the previous batch
+            reap();
+        }
+        Member* pMember = NULL;
+        Thread* pThread = NULL;
+        try {
+            pMember = new Member();
+            pMember->pGroup = this;
+            pMember->task = task;
+            threads_.reserve(threads_.size() + 1);
+            pThread = new Thread(attributes_);
+        }
+        catch (...) {
+            delete pMember;
+            Task(task).destroy();
+            throw;
+        }
+        __atomic_add_fetch(&remaining_, 1, __ATOMIC_RELAXED);
+        const char* error =
+            pThread->createThread(&ThreadGroup::startMember, pMember, false);
+        if (error != NULL) {
+            __atomic_sub_fetch(&remaining_, 1, __ATOMIC_RELAXED);
+            delete pThread;
+            delete pMember;
+            Task(task).destroy();
+            throw Thread::Exception(0, error);
+        }
+        threads_.push_back(pThread);
+    }
+
+    static void* startMember(void* data) {
+        Member* pMember = static_cast<Member*>(data);
+        ThreadGroup* pGroup = pMember->pGroup;
+        Task task = pMember->task;
+        delete pMember;
+        int completionFd = pGroup->attributes_.completion_fd();
+        while (__atomic_load_n(&pGroup->released_, __ATOMIC_ACQUIRE) == 0) {
+            Thread::futexWait(&pGroup->released_, 0);
+        }
+        CapturedException* pException = task.run();
+        if (pException != NULL) {
+            CapturedException* pExpected = NULL;
+            // keep the first one
+            if (!__atomic_compare_exchange_n(&pGroup->pException_, &pExpected,
+                                             pException, false,
+                                             __ATOMIC_RELEASE,
+                                             __ATOMIC_RELAXED)) {
+                delete pException;
+            }
+        }
+        if (__atomic_sub_fetch(&pGroup->remaining_, 1, __ATOMIC_ACQ_REL) ==
+            0) {
+            // the whole batch is over
+            Thread::notifyCompletion(completionFd);
+            Thread::futexWake(&pGroup->remaining_);
+        }
+        return NULL;
+    }
+
+    // join the finished threads and close the barrier for the next batch
+    void reap() {
+        for (std::size_t i = 0; i < threads_.size(); ++i) {
+            // the exit value is always NULL
+            threads_[i]->join();
+            delete threads_[i];
+        }
+        threads_.clear();
+        isJoined_ = false;
+        __atomic_store_n(&released_, 0, __ATOMIC_RELAXED);
+    }
+
+    Thread::Attributes attributes_;
+    std::vector<Thread*> threads_;
+    // threads_ all returned, reaped by the next submit
+    bool isJoined_;
+    int released_;
+    int remaining_;
+    CapturedException* pException_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_THREAD_GROUP_H_
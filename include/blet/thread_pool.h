@@ -0,0 +1,156 @@
+/**
+ * thread_pool.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_THREAD_POOL_H_
+#define BLET_THREAD_POOL_H_
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <deque>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Fixed number of Thread workers running the calls given to submit from a
+ * shared queue.
+ * The destructor runs the remaining calls before stopping the workers.
+ */
+class ThreadPool : public PoolExecutor<ThreadPool> {
+  public:
+    /**
+     * Start size workers, or one per online CPU when size is 0.
+     */
+    explicit ThreadPool(std::size_t size = 0) :
+        threads_(NULL),
+        workers_(NULL),
+        size_(size),
+        queued_(0) {
+        if (size_ == 0) {
+            long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+            size_ = cpus > 0 ? static_cast<std::size_t>(cpus) : 1;
+        }
+        ::pthread_mutex_init(&mutex_, NULL);
+        try {
+            workers_ = new Worker[size_];
+            threads_ = new Thread[size_];
+            for (std::size_t i = 0; i < size_; ++i) {
+                threads_[i].start(&ThreadPool::run, this, &workers_[i]);
+            }
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~ThreadPool() {
+        stop();
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+  private:
+    friend class Executor<ThreadPool>;
+    friend class PoolExecutor<ThreadPool>;
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    struct Worker : public WorkerState {
+        char padding[64];
+    };
+
+    void push(const Task& task) {
+        addPending();
+        ::pthread_mutex_lock(&mutex_);
+        try {
+            tasks_.push_back(task);
+        }
+        catch (...) {
+            ::pthread_mutex_unlock(&mutex_);
+            removePending();
+            Task(task).destroy();
+            throw;
+        }
+        __atomic_store_n(&queued_, tasks_.size(), __ATOMIC_RELAXED);
+        ::pthread_mutex_unlock(&mutex_);
+        wake(&sleepers_, 1, 0);
+    }
+
+    bool findTask(Worker*, Task& task) {
+        if (!hasTask()) {
+            return false;
+        }
+        bool isFound = false;
+        ::pthread_mutex_lock(&mutex_);
+        if (!tasks_.empty()) {
+            task = tasks_.front();
+            tasks_.pop_front();
+            __atomic_store_n(&queued_, tasks_.size(), __ATOMIC_RELAXED);
+            isFound = true;
+        }
+        ::pthread_mutex_unlock(&mutex_);
+        return isFound;
+    }
+
+    bool hasTask() const {
+        return __atomic_load_n(&queued_, __ATOMIC_RELAXED) != 0;
+    }
+
+    const WorkerState& worker(std::size_t index) const {
+        return workers_[index];
+    }
+
+    void run(Worker* pWorker) {
+        runWorker(pWorker, sleepers_);
+    }
+
+    void stop() {
+        stopWorkers(&sleepers_, 1);
+        // join the workers
+        delete[] threads_;
+        delete[] workers_;
+        ::pthread_mutex_destroy(&mutex_);
+    }
+
+    Thread* threads_;
+    Worker* workers_;
+    std::size_t size_;
+    // tasks_.size() readable without the mutex
+    std::size_t queued_;
+    std::deque<Task> tasks_;
+    ::pthread_mutex_t mutex_;
+    Sleepers sleepers_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_THREAD_POOL_H_
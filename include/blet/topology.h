@@ -0,0 +1,365 @@
+/**
+ * topology.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BLET_TOPOLOGY_H_
+#define BLET_TOPOLOGY_H_
+
+#include <sched.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace blet {
+
+/**
+ * CPU layout read from /sys/devices/system/cpu (Linux).
+ * Describes the package, the core, the SMT siblings and the caches of each
+ * online CPU, to build the cpu_set_t given to Thread::Attributes.
+ * A file that cannot be read leaves the matching value unknown (-1 or an
+ * empty set), a missing root gives a Topology without any CPU.
+ */
+class Topology {
+  public:
+    enum CacheType {
+        CACHE_DATA,
+        CACHE_INSTRUCTION,
+        CACHE_UNIFIED
+    };
+
+    struct Cache {
+        int level;
+        CacheType type;
+        // bytes, 0 when unknown
+        std::size_t size;
+        cpu_set_t cpus;
+    };
+
+    struct Cpu {
+        int id;
+        int package;
+        int core;
+        // SMT threads of the same core, this one included
+        cpu_set_t siblings;
+        std::vector<Cache> caches;
+    };
+
+    explicit Topology(const char* root = "/sys/devices/system/cpu") {
+        CPU_ZERO(&online_);
+        CPU_ZERO(&isolated_);
+        std::string path(root);
+        std::string value;
+        if (!readFile(path + "/online", &value) ||
+            !parse_cpu_list(value.c_str(), &online_)) {
+            CPU_ZERO(&online_);
+            return;
+        }
+        if (readFile(path + "/isolated", &value)) {
+            parse_cpu_list(value.c_str(), &isolated_);
+        }
+        for (int id = 0; id < CPU_SETSIZE; ++id) {
+            if (CPU_ISSET(id, &online_)) {
+                cpus_.push_back(Cpu());
+                readCpu(path + "/cpu" + toString(id), id, &cpus_.back());
+            }
+        }
+    }
+
+    const std::vector<Cpu>& cpus() const {
+        return cpus_;
+    }
+
+    /**
+     * NULL when the CPU is not online.
+     */
+    const Cpu* cpu(int id) const {
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            if (cpus_[i].id == id) {
+                return &cpus_[i];
+            }
+        }
+        return NULL;
+    }
+
+    const cpu_set_t& online() const {
+        return online_;
+    }
+
+    /**
+     * CPUs removed from the scheduler with isolcpus, the latency cores.
+     */
+    const cpu_set_t& isolated() const {
+        return isolated_;
+    }
+
+    std::size_t package_count() const {
+        std::vector<int> packages;
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            addUnique(&packages, cpus_[i].package);
+        }
+        return packages.size();
+    }
+
+    std::size_t core_count() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            // count the first SMT thread of each core
+            bool isFirst = true;
+            for (std::size_t j = 0; j < i && isFirst; ++j) {
+                isFirst = !isSameCore(cpus_[i], cpus_[j]);
+            }
+            count += isFirst;
+        }
+        return count;
+    }
+
+    cpu_set_t package_cpus(int package) const {
+        cpu_set_t result;
+        CPU_ZERO(&result);
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            if (cpus_[i].package == package) {
+                CPU_SET(cpus_[i].id, &result);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * CPUs sharing the data or unified cache of this level with cpu, empty
+     * when unknown.
+     */
+    cpu_set_t cache_cpus(int cpu, int level) const {
+        cpu_set_t result;
+        CPU_ZERO(&result);
+        const Cache* pCache = findCache(cpu, level);
+        if (pCache != NULL) {
+            result = pCache->cpus;
+        }
+        return result;
+    }
+
+    /**
+     * Another online CPU sharing the cache of this level with cpu,
+     * preferably on a different core, else an SMT sibling of cpu.
+     * Return -1 when no CPU shares this cache.
+     */
+    int sharing_cpu(int cpu, int level) const {
+        const Cpu* pCpu = this->cpu(cpu);
+        const Cache* pCache = findCache(cpu, level);
+        if (pCpu == NULL || pCache == NULL) {
+            return -1;
+        }
+        int sibling = -1;
+        for (std::size_t i = 0; i < cpus_.size(); ++i) {
+            const Cpu& other = cpus_[i];
+            if (other.id == cpu || !CPU_ISSET(other.id, &pCache->cpus)) {
+                continue;
+            }
+            if (!isSameCore(*pCpu, other)) {
+                return other.id;
+            }
+            if (sibling == -1) {
+                sibling = other.id;
+            }
+        }
+        return sibling;
+    }
+
+    /**
+     * Parse a sysfs CPU list like "0-3,8,10-11".
+     * Return false on a malformed list, CPUs above CPU_SETSIZE are ignored.
+     */
+    static bool parse_cpu_list(const char* str, cpu_set_t* pCpus) {
+        CPU_ZERO(pCpus);
+        const char* p = str;
+        while (*p == ' ' || *p == '\n') {
+            ++p;
+        }
+        while (*p != '\0' && *p != '\n') {
+            long first = 0;
+            if (!parseNumber(&p, &first)) {
+                return false;
+            }
+            long last = first;
+            if (*p == '-') {
+                ++p;
+                if (!parseNumber(&p, &last) || last < first) {
+                    return false;
+                }
+            }
+            for (long id = first; id <= last && id < CPU_SETSIZE; ++id) {
+                CPU_SET(id, pCpus);
+            }
+            if (*p == ',') {
+                ++p;
+            }
+            else if (*p != '\0' && *p != '\n') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    static bool parseNumber(const char** pp, long* pValue) {
+        const char* p = *pp;
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        long value = 0;
+        while (*p >= '0' && *p <= '9' && value < 1000000) {
+            value = value * 10 + (*p - '0');
+            ++p;
+        }
+        *pp = p;
+        *pValue = value;
+        return true;
+    }
+
+    // first line of the file without its new line
+    static bool readFile(const std::string& path, std::string* pValue) {
+        std::FILE* pFile = std::fopen(path.c_str(), "r");
+        if (pFile == NULL) {
+            return false;
+        }
+        char buffer[4096];
+        bool isRead = std::fgets(buffer, sizeof(buffer), pFile) != NULL;
+        std::fclose(pFile);
+        if (!isRead) {
+            return false;
+        }
+        pValue->assign(buffer);
+        while (!pValue->empty() && ((*pValue)[pValue->size() - 1] == '\n' ||
+                                    (*pValue)[pValue->size() - 1] == ' ')) {
+            pValue->erase(pValue->size() - 1);
+        }
+        return true;
+    }
+
+    static int readInt(const std::string& path) {
+        std::string value;
+        const char* p = NULL;
+        long result = -1;
+        if (readFile(path, &value)) {
+            p = value.c_str();
+            if (!parseNumber(&p, &result)) {
+                result = -1;
+            }
+        }
+        return static_cast<int>(result);
+    }
+
+    static std::string toString(int value) {
+        char buffer[16];
+        std::sprintf(buffer, "%d", value);
+        return buffer;
+    }
+
+    static void readCpu(const std::string& path, int id, Cpu* pCpu) {
+        std::string value;
+        pCpu->id = id;
+        pCpu->package = readInt(path + "/topology/physical_package_id");
+        pCpu->core = readInt(path + "/topology/core_id");
+        if (!readFile(path + "/topology/thread_siblings_list", &value) ||
+            !parse_cpu_list(value.c_str(), &pCpu->siblings)) {
+            CPU_ZERO(&pCpu->siblings);
+            CPU_SET(id, &pCpu->siblings);
+        }
+        for (int index = 0;; ++index) {
+            std::string cachePath = path + "/cache/index" + toString(index);
+            Cache cache;
+            cache.level = readInt(cachePath + "/level");
+            if (cache.level < 0) {
+                break;
+            }
+            cache.type = CACHE_UNIFIED;
+            if (readFile(cachePath + "/type", &value)) {
+                if (value == "Data") {
+                    cache.type = CACHE_DATA;
+                }
+                else if (value == "Instruction") {
+                    cache.type = CACHE_INSTRUCTION;
+                }
+            }
+            cache.size = 0;
+            if (readFile(cachePath + "/size", &value)) {
+                const char* p = value.c_str();
+                long size = 0;
+                if (parseNumber(&p, &size)) {
+                    cache.size = static_cast<std::size_t>(size);
+                    if (*p == 'K') {
+                        cache.size *= 1024;
+                    }
+                    else if (*p == 'M') {
+                        cache.size *= 1024 * 1024;
+                    }
+                }
+            }
+            if (!readFile(cachePath + "/shared_cpu_list", &value) ||
+                !parse_cpu_list(value.c_str(), &cache.cpus)) {
+                CPU_ZERO(&cache.cpus);
+                CPU_SET(id, &cache.cpus);
+            }
+            pCpu->caches.push_back(cache);
+        }
+    }
+
+    const Cache* findCache(int cpu, int level) const {
+        const Cpu* pCpu = this->cpu(cpu);
+        if (pCpu == NULL) {
+            return NULL;
+        }
+        for (std::size_t i = 0; i < pCpu->caches.size(); ++i) {
+            const Cache& cache = pCpu->caches[i];
+            if (cache.level == level && cache.type != CACHE_INSTRUCTION) {
+                return &cache;
+            }
+        }
+        return NULL;
+    }
+
+    static bool isSameCore(const Cpu& first, const Cpu& second) {
+        return CPU_ISSET(second.id, &first.siblings);
+    }
+
+    static void addUnique(std::vector<int>* pValues, int value) {
+        for (std::size_t i = 0; i < pValues->size(); ++i) {
+            if ((*pValues)[i] == value) {
+                return;
+            }
+        }
+        pValues->push_back(value);
+    }
+
+    std::vector<Cpu> cpus_;
+    cpu_set_t online_;
+    cpu_set_t isolated_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_TOPOLOGY_H_
@@ -0,0 +1,383 @@
+/**
+ * work_stealing_pool.h
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLET_WORK_STEALING_POOL_H_
+#define BLET_WORK_STEALING_POOL_H_
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <deque>
+
+#include "blet/thread.h"
+
+namespace blet {
+
+/**
+ * Chase-Lev deque.
+ * The owner thread pushes and pops at the bottom (LIFO), any other thread
+ * steals at the top (FIFO).
+ * T is copied with the generic __atomic builtins so a pointer sized T keeps
+ * the deque lock-free.
+ * The buffer doubles when full, the previous buffers are kept until
+ * destruction because a thief may still read them.
+ */
+template<typename T>
+class WorkStealingDeque {
+  public:
+    explicit WorkStealingDeque(std::size_t capacity = 256) :
+        top_(0),
+        bottom_(0),
+        pArray_(NULL) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        pArray_ = new Array(size, NULL);
+    }
+
+    ~WorkStealingDeque() {
+        Array* pArray = pArray_;
+        while (pArray != NULL) {
+            Array* pPrevious = pArray->pPrevious;
+            delete pArray;
+            pArray = pPrevious;
+        }
+    }
+
+    /**
+     * Owner only.
+     */
+    void push(const T& value) {
+        long bottom = __atomic_load_n(&bottom_, __ATOMIC_RELAXED);
+        long top = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        Array* pArray = __atomic_load_n(&pArray_, __ATOMIC_RELAXED);
+        if (bottom - top > static_cast<long>(pArray->mask)) {
+            pArray = grow(pArray, top, bottom);
+        }
+        pArray->put(bottom, value);
+        // publish the value to the thieves
+        __atomic_store_n(&bottom_, bottom + 1, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Owner only, take the last pushed value.
+     */
+    bool pop(T& value) {
+        long bottom = __atomic_load_n(&bottom_, __ATOMIC_RELAXED) - 1;
+        Array* pArray = __atomic_load_n(&pArray_, __ATOMIC_RELAXED);
+        __atomic_store_n(&bottom_, bottom, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        long top = __atomic_load_n(&top_, __ATOMIC_RELAXED);
+        if (top > bottom) {
+            __atomic_store_n(&bottom_, bottom + 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        value = pArray->get(bottom);
+        if (top == bottom) {
+            // last value, race against the thieves
+            bool isTaken =
+                __atomic_compare_exchange_n(&top_, &top, top + 1, false,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+            __atomic_store_n(&bottom_, bottom + 1, __ATOMIC_RELAXED);
+            return isTaken;
+        }
+        return true;
+    }
+
+    /**
+     * Any thread, take the first pushed value.
+     * Also fails when another thief won the race for the same value.
+     */
+    bool steal(T& value) {
+        long top = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        long bottom = __atomic_load_n(&bottom_, __ATOMIC_ACQUIRE);
+        if (top >= bottom) {
+            return false;
+        }
+        Array* pArray = __atomic_load_n(&pArray_, __ATOMIC_ACQUIRE);
+        T stolen = pArray->get(top);
+        if (!__atomic_compare_exchange_n(&top_, &top, top + 1, false,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            return false;
+        }
+        value = stolen;
+        return true;
+    }
+
+    bool empty() const {
+        long bottom = __atomic_load_n(&bottom_, __ATOMIC_ACQUIRE);
+        long top = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        return top >= bottom;
+    }
+
+  private:
+    WorkStealingDeque(const WorkStealingDeque&);
+    WorkStealingDeque& operator=(const WorkStealingDeque&);
+
+    struct Array {
+        Array(std::size_t size, Array* pPreviousArray) :
+            mask(size - 1),
+            pPrevious(pPreviousArray),
+            values(new T[size]) {}
+        ~Array() {
+            delete[] values;
+        }
+        void put(long index, const T& value) {
+            T copy(value);
+            __atomic_store(&values[index & mask], &copy, __ATOMIC_RELAXED);
+        }
+        T get(long index) const {
+            T value;
+            __atomic_load(&values[index & mask], &value, __ATOMIC_RELAXED);
+            return value;
+        }
+        std::size_t mask;
+        Array* pPrevious;
+        T* values;
+    };
+
+    Array* grow(Array* pArray, long top, long bottom) {
+        Array* pNewArray = new Array((pArray->mask + 1) * 2, pArray);
+        for (long i = top; i < bottom; ++i) {
+            pNewArray->put(i, pArray->get(i));
+        }
+        __atomic_store_n(&pArray_, pNewArray, __ATOMIC_RELEASE);
+        return pNewArray;
+    }
+
+    long top_;
+    char paddingTop_[64 - sizeof(long)];
+    long bottom_;
+    Array* pArray_;
+    char paddingBottom_[64 - sizeof(long) - sizeof(Array*)];
+};
+
+/**
+ * Fixed number of Thread workers, each one owning a WorkStealingDeque of
+ * Task.
+ * A call submitted from a worker goes to its own deque, others go to a shared
+ * injection queue.
+ * An idle worker takes from its deque, then the injection queue, then steals
+ * from the other workers starting at a random victim, and parks when
+ * everything is empty.
+ * The destructor runs the remaining calls before stopping the workers.
+ */
+class WorkStealingPool : public PoolExecutor<WorkStealingPool> {
+  public:
+    struct Stats {
+        // calls taken from the deque of the worker that submitted them
+        unsigned long localHits;
+        // calls taken from the deque of another worker
+        unsigned long steals;
+        // calls taken from the injection queue
+        unsigned long injected;
+    };
+
+    /**
+     * Start size workers, or one per online CPU when size is 0.
+     */
+    explicit WorkStealingPool(std::size_t size = 0) :
+        threads_(NULL),
+        workers_(NULL),
+        size_(size),
+        injectedSize_(0) {
+        if (size_ == 0) {
+            long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+            size_ = cpus > 0 ? static_cast<std::size_t>(cpus) : 1;
+        }
+        ::pthread_mutex_init(&injectedMutex_, NULL);
+        try {
+            workers_ = new Worker[size_];
+            threads_ = new Thread[size_];
+            for (std::size_t i = 0; i < size_; ++i) {
+                workers_[i].seed =
+                    static_cast<unsigned int>(i) * 2654435761u + 1;
+                threads_[i].start(&WorkStealingPool::run, this, &workers_[i]);
+            }
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~WorkStealingPool() {
+        stop();
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    Stats stats() const {
+        Stats result;
+        result.localHits = 0;
+        result.steals = 0;
+        result.injected = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            result.localHits +=
+                __atomic_load_n(&workers_[i].localHits, __ATOMIC_RELAXED);
+            result.steals +=
+                __atomic_load_n(&workers_[i].steals, __ATOMIC_RELAXED);
+            result.injected +=
+                __atomic_load_n(&workers_[i].injected, __ATOMIC_RELAXED);
+        }
+        return result;
+    }
+
+  private:
+    friend class Executor<WorkStealingPool>;
+    friend class PoolExecutor<WorkStealingPool>;
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+
+    struct Worker : public WorkerState {
+        Worker() :
+            seed(1),
+            localHits(0),
+            steals(0),
+            injected(0) {}
+        WorkStealingDeque<Task> deque;
+        unsigned int seed;
+        unsigned long localHits;
+        unsigned long steals;
+        unsigned long injected;
+        char padding[64];
+    };
+
+    const WorkerState& worker(std::size_t index) const {
+        return workers_[index];
+    }
+
+    void push(const Task& task) {
+        addPending();
+        try {
+            Worker* pWorker = static_cast<Worker*>(callerWorker());
+            if (pWorker != NULL) {
+                pWorker->deque.push(task);
+            }
+            else {
+                ::pthread_mutex_lock(&injectedMutex_);
+                try {
+                    injectedTasks_.push_back(task);
+                }
+                catch (...) {
+                    ::pthread_mutex_unlock(&injectedMutex_);
+                    throw;
+                }
+                __atomic_store_n(&injectedSize_, injectedTasks_.size(),
+                                 __ATOMIC_RELAXED);
+                ::pthread_mutex_unlock(&injectedMutex_);
+            }
+        }
+        catch (...) {
+            removePending();
+            Task(task).destroy();
+            throw;
+        }
+        wake(&sleepers_, 1, 0);
+    }
+
+    void run(Worker* pWorker) {
+        runWorker(pWorker, sleepers_);
+    }
+
+    bool findTask(Worker* pWorker, Task& task) {
+        if (pWorker->deque.pop(task)) {
+            increment(pWorker->localHits);
+            return true;
+        }
+        if (popInjected(task)) {
+            increment(pWorker->injected);
+            return true;
+        }
+        // xorshift
+        pWorker->seed ^= pWorker->seed << 13;
+        pWorker->seed ^= pWorker->seed >> 17;
+        pWorker->seed ^= pWorker->seed << 5;
+        std::size_t victim = pWorker->seed % size_;
+        for (std::size_t i = 0; i < size_; ++i) {
+            Worker* pVictim = &workers_[(victim + i) % size_];
+            if (pVictim != pWorker && pVictim->deque.steal(task)) {
+                increment(pWorker->steals);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool popInjected(Task& task) {
+        if (__atomic_load_n(&injectedSize_, __ATOMIC_RELAXED) == 0) {
+            return false;
+        }
+        bool isFound = false;
+        ::pthread_mutex_lock(&injectedMutex_);
+        if (!injectedTasks_.empty()) {
+            task = injectedTasks_.front();
+            injectedTasks_.pop_front();
+            __atomic_store_n(&injectedSize_, injectedTasks_.size(),
+                             __ATOMIC_RELAXED);
+            isFound = true;
+        }
+        ::pthread_mutex_unlock(&injectedMutex_);
+        return isFound;
+    }
+
+    bool hasTask() const {
+        if (__atomic_load_n(&injectedSize_, __ATOMIC_RELAXED) != 0) {
+            return true;
+        }
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (!workers_[i].deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void stop() {
+        stopWorkers(&sleepers_, 1);
+        // join the workers
+        delete[] threads_;
+        delete[] workers_;
+        ::pthread_mutex_destroy(&injectedMutex_);
+    }
+
+    Thread* threads_;
+    Worker* workers_;
+    std::size_t size_;
+    std::size_t injectedSize_;
+    std::deque<Task> injectedTasks_;
+    ::pthread_mutex_t injectedMutex_;
+    Sleepers sleepers_;
+};
+
+} // namespace blet
+
+#endif // #ifndef BLET_WORK_STEALING_POOL_H_
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "blet/atomic_wait.h"
+#include "blet/future.h"
+#include "blet/thread.h"
+
+static void waitValue(int* pValue, int* pWoken) {
+    int value = __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+    while (value == 0) {
+        blet::atomic_wait(pValue, 0);
+        value = __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+    }
+    __atomic_add_fetch(pWoken, 1, __ATOMIC_RELEASE);
+}
+
+GTEST_TEST(atomicWait, changed) {
+    int value = 1;
+    // not expected, returns at once
+    blet::atomic_wait(&value, 0);
+    blet::atomic_notify_one(&value);
+    blet::atomic_notify_all(&value);
+}
+
+GTEST_TEST(atomicWait, notifyOne) {
+    int value = 0;
+    int woken = 0;
+    blet::Thread thrd(&waitValue, &value, &woken);
+    ::sched_yield();
+    EXPECT_EQ(__atomic_load_n(&woken, __ATOMIC_ACQUIRE), 0);
+    __atomic_store_n(&value, 1, __ATOMIC_RELEASE);
+    blet::atomic_notify_one(&value);
+    thrd.join();
+    EXPECT_EQ(woken, 1);
+}
+
+GTEST_TEST(atomicWait, notifyAll) {
+    int value = 0;
+    int woken = 0;
+    std::vector<blet::Thread> threads(4);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&waitValue, &value, &woken);
+    }
+    __atomic_store_n(&value, 1, __ATOMIC_RELEASE);
+    blet::atomic_notify_all(&value);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(woken, 4);
+}
+
+static void parkCount(int rounds, int* pCount) {
+    for (int i = 0; i < rounds; ++i) {
+        blet::park();
+        __atomic_add_fetch(pCount, 1, __ATOMIC_RELEASE);
+    }
+}
+
+// larger than BLET_THREAD_INLINE_SIZE
+struct Large {
+    char data[BLET_THREAD_INLINE_SIZE + 1];
+};
+
+static void parkLarge(Large, int* pCount) {
+    parkCount(1, pCount);
+}
+
+static void waitCount(int* pCount, int count) {
+    while (__atomic_load_n(pCount, __ATOMIC_ACQUIRE) < count) {
+        ::sched_yield();
+    }
+}
+
+GTEST_TEST(park, unpark) {
+    int count = 0;
+    blet::Thread thrd(&parkCount, 3, &count);
+    for (int i = 1; i <= 3; ++i) {
+        ::sched_yield();
+        EXPECT_EQ(__atomic_load_n(&count, __ATOMIC_ACQUIRE), i - 1);
+        blet::unpark(thrd);
+        waitCount(&count, i);
+    }
+    thrd.join();
+}
+
+static void parkTwice(int* pFlag, int* pCount) {
+    while (__atomic_load_n(pFlag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+    parkCount(2, pCount);
+}
+
+GTEST_TEST(park, tokenBeforePark) {
+    int flag = 0;
+    int count = 0;
+    blet::Thread thrd(&parkTwice, &flag, &count);
+    // several unpark count as one
+    blet::unpark(thrd);
+    blet::unpark(thrd);
+    __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+    waitCount(&count, 1);
+    ::sched_yield();
+    EXPECT_EQ(__atomic_load_n(&count, __ATOMIC_ACQUIRE), 1);
+    blet::unpark(thrd);
+    thrd.join();
+    EXPECT_EQ(count, 2);
+}
+
+GTEST_TEST(park, notRunning) {
+    int count = 0;
+    blet::Thread thrd;
+    // not started, joined
+    blet::unpark(thrd);
+    thrd.start(&waitCount, &count, 0);
+    thrd.join();
+    blet::unpark(thrd);
+    // no Thread can unpark the main thread
+    blet::park();
+}
+
+GTEST_TEST(park, heapCall) {
+    int count = 0;
+    blet::Thread thrd(&parkLarge, Large(), &count);
+    blet::unpark(thrd);
+    thrd.join();
+    EXPECT_EQ(count, 1);
+}
+
+GTEST_TEST(park, persistent) {
+    int count = 0;
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    for (int i = 1; i <= 3; ++i) {
+        thrd.start(&parkCount, 1, &count);
+        blet::unpark(thrd);
+        thrd.join();
+        EXPECT_EQ(count, i);
+    }
+}
+
+static int parkValue(int value) {
+    blet::park();
+    return value;
+}
+
+GTEST_TEST(park, async) {
+    // detached thread, returns at once
+    blet::Future<int> future = blet::async(&parkValue, 42);
+    EXPECT_EQ(future.get(), 42);
+}
+
+static void parkDone(int* pDone) {
+    blet::park();
+    __atomic_store_n(pDone, 1, __ATOMIC_RELEASE);
+}
+
+static void parkLargeDone(Large, int* pDone) {
+    parkDone(pDone);
+}
+
+static void waitDone(int* pDone) {
+    while (__atomic_load_n(pDone, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+static void parkAfterFlag(int* pFlag, int* pDone) {
+    __atomic_store_n(pFlag, 1, __ATOMIC_RELEASE);
+    parkDone(pDone);
+}
+
+GTEST_TEST(park, detached) {
+    int flag = 0;
+    int done = 0;
+    {
+        blet::Thread thrd(&parkAfterFlag, &flag, &done);
+        waitDone(&flag);
+        ::usleep(10000);
+        // wakes the parked thread for good
+        thrd.detach();
+        blet::unpark(thrd);
+    }
+    waitDone(&done);
+
+    blet::Thread::Attributes attributes;
+    attributes.set_detached(true);
+    int inlineDone = 0;
+    int heapDone = 0;
+    {
+        blet::Thread inlineThread(attributes);
+        inlineThread.start(&parkDone, &inlineDone);
+        blet::Thread heapThread(attributes);
+        heapThread.start(&parkLargeDone, Large(), &heapDone);
+    }
+    waitDone(&inlineDone);
+    waitDone(&heapDone);
+}
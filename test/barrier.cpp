@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "blet/barrier.h"
+#include "blet/thread.h"
+
+struct Phases {
+    Phases(unsigned int count, unsigned int spinCount) :
+        barrier(count, spinCount),
+        arrived(0),
+        serial(0),
+        errors(0) {}
+    blet::Barrier barrier;
+    int arrived;
+    int serial;
+    int errors;
+};
+
+static void runPhases(Phases* pPhases, int phaseCount) {
+    int count = static_cast<int>(pPhases->barrier.count());
+    for (int phase = 1; phase <= phaseCount; ++phase) {
+        __atomic_add_fetch(&pPhases->arrived, 1, __ATOMIC_RELAXED);
+        if (pPhases->barrier.arrive_and_wait()) {
+            __atomic_add_fetch(&pPhases->serial, 1, __ATOMIC_RELAXED);
+        }
+        // every thread of the phase has arrived
+        if (__atomic_load_n(&pPhases->arrived, __ATOMIC_RELAXED) <
+            phase * count) {
+            __atomic_add_fetch(&pPhases->errors, 1, __ATOMIC_RELAXED);
+        }
+        // and none has left for the next one
+        pPhases->barrier.arrive_and_wait();
+    }
+}
+
+static void testPhases(unsigned int spinCount) {
+    const int phaseCount = 1000;
+    Phases phases(4, spinCount);
+    std::vector<blet::Thread> threads(4);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&runPhases, &phases, phaseCount);
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(phases.errors, 0);
+    EXPECT_EQ(phases.arrived, 4 * phaseCount);
+    EXPECT_EQ(phases.serial, phaseCount);
+}
+
+GTEST_TEST(barrier, single) {
+    blet::Barrier barrier(1);
+    EXPECT_EQ(barrier.count(), 1U);
+    EXPECT_TRUE(barrier.arrive_and_wait());
+    EXPECT_TRUE(barrier.arrive_and_wait());
+}
+
+GTEST_TEST(barrier, spin) {
+    testPhases(BLET_BARRIER_SPIN);
+}
+
+GTEST_TEST(barrier, park) {
+    // park at once
+    testPhases(0);
+}
+
+static void countDown(blet::Latch* pLatch) {
+    pLatch->count_down();
+}
+
+static void arriveAndWait(blet::Latch* pLatch, int* pDone) {
+    pLatch->arrive_and_wait();
+    __atomic_add_fetch(pDone, 1, __ATOMIC_RELAXED);
+}
+
+GTEST_TEST(latch, countDown) {
+    blet::Latch latch(3);
+    EXPECT_FALSE(latch.try_wait());
+    latch.count_down(2);
+    EXPECT_FALSE(latch.try_wait());
+    latch.count_down();
+    EXPECT_TRUE(latch.try_wait());
+    latch.wait();
+
+    blet::Latch zero(0);
+    EXPECT_TRUE(zero.try_wait());
+    zero.wait();
+}
+
+GTEST_TEST(latch, wait) {
+    blet::Latch latch(4, 0);
+    std::vector<blet::Thread> threads(4);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&countDown, &latch);
+    }
+    latch.wait();
+    EXPECT_TRUE(latch.try_wait());
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+}
+
+GTEST_TEST(latch, arriveAndWait) {
+    int done = 0;
+    blet::Latch latch(4);
+    std::vector<blet::Thread> threads(3);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&arriveAndWait, &latch, &done);
+    }
+    EXPECT_EQ(__atomic_load_n(&done, __ATOMIC_RELAXED), 0);
+    arriveAndWait(&latch, &done);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(done, 4);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "blet/future.h"
+#include "blet/mockc.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+struct MyTest {
+    MyTest() :
+        count(0) {}
+
+    static int staticMethodVoid() {
+        return 42;
+    }
+    static std::string staticMethodArg2(std::string a1, int a2) {
+        return a1 + std::string(a2, '!');
+    }
+    static int staticMethodArg10(int a1, int a2, int a3, int a4, int a5,
+                                 int a6, int a7, int a8, int a9, int a10) {
+        return a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10;
+    }
+    static int& staticMethodRef(int* a1) {
+        return *a1;
+    }
+    static void staticMethodSleep(int* a1) {
+        ::usleep(50000);
+        *a1 = 1;
+    }
+
+    int methodArg1(int a1) {
+        count += a1;
+        return count;
+    }
+    int methodConst() const {
+        return count;
+    }
+
+    int count;
+};
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+
+GTEST_TEST(future, static) {
+    blet::Future<int> f0 = blet::async(&MyTest::staticMethodVoid);
+    blet::Future<std::string> f2 =
+        blet::async(&MyTest::staticMethodArg2, std::string("hello"), 3);
+    blet::Future<int> f10 =
+        blet::async(&MyTest::staticMethodArg10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+    EXPECT_EQ(f0.get(), 42);
+    EXPECT_EQ(f2.get(), "hello!!!");
+    EXPECT_EQ(f10.get(), 55);
+}
+
+GTEST_TEST(future, reference) {
+    int value = 0;
+    blet::Future<int&> f = blet::async(&MyTest::staticMethodRef, &value);
+    EXPECT_EQ(&f.get(), &value);
+}
+
+GTEST_TEST(future, void) {
+    int value = 0;
+    blet::Future<void> f = blet::async(&MyTest::staticMethodSleep, &value);
+    EXPECT_TRUE(f.valid());
+    f.get();
+    EXPECT_TRUE(f.is_ready());
+    EXPECT_EQ(value, 1);
+}
+
+GTEST_TEST(future, method) {
+    MyTest t;
+    blet::Future<int> f1 = blet::async(&MyTest::methodArg1, &t, 42);
+    EXPECT_EQ(f1.get(), 42);
+    blet::Future<int> f2 = blet::async(&MyTest::methodConst,
+                                       static_cast<const MyTest*>(&t));
+    EXPECT_EQ(f2.get(), 42);
+}
+
+GTEST_TEST(future, copy) {
+    blet::Future<int> empty;
+    EXPECT_FALSE(empty.valid());
+    blet::Future<std::string> f;
+    {
+        blet::Future<std::string> tmp =
+            blet::async(&MyTest::staticMethodArg2, std::string("copy"), 1);
+        blet::Future<std::string> copy(tmp);
+        f = copy;
+        blet::Future<std::string>& self = f;
+        f = self;
+    }
+    f.wait();
+    EXPECT_TRUE(f.is_ready());
+    // get does not consume the result
+    EXPECT_EQ(f.get(), "copy!");
+    EXPECT_EQ(f.get(), "copy!");
+    f = blet::Future<std::string>();
+    EXPECT_FALSE(f.valid());
+}
+
+static void waitFuture(blet::Future<void>* pFuture, int* pReady) {
+    pFuture->wait();
+    __atomic_fetch_add(pReady, 1, __ATOMIC_RELAXED);
+}
+
+GTEST_TEST(future, waiters) {
+    int value = 0;
+    int ready = 0;
+    blet::Future<void> f = blet::async(&MyTest::staticMethodSleep, &value);
+    blet::Thread waiters[4];
+    for (int i = 0; i < 4; ++i) {
+        waiters[i].start(&waitFuture, &f, &ready);
+    }
+    for (int i = 0; i < 4; ++i) {
+        waiters[i].join();
+    }
+    EXPECT_EQ(ready, 4);
+    EXPECT_EQ(value, 1);
+}
+
+GTEST_TEST(future, createException) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            try {
+                blet::async(&MyTest::staticMethodVoid);
+            }
+            catch (const blet::Thread::Exception& e) {
+                EXPECT_STREQ(e.what(), "Failed to create thread");
+                throw;
+            }
+        },
+        blet::Thread::Exception);
+}
+
+static int throwRuntimeError(const char* a1) {
+    throw std::runtime_error(a1);
+}
+
+GTEST_TEST(future, exception) {
+    blet::Future<int> f = blet::async(&throwRuntimeError, "boom");
+    // rethrown by every get
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_THROW(
+            {
+                try {
+                    f.get();
+                }
+                catch (const std::exception& e) {
+                    EXPECT_STREQ(e.what(), "boom");
+                    throw;
+                }
+            },
+            std::exception);
+    }
+    // never waited, dropped with the shared state
+    blet::async(&throwRuntimeError, "dropped");
+}
@@ -203,10 +203,11 @@ struct MockC_Singleton {
             MOCKC_GUARD_REVERSE(n);                                                                      \
             return MOCKC_INSTANCE(n).n(MOCKC_CAT2_(MOCKC_REPEAT_, i, _)(MOCKC_ARG_, f));                 \
         }                                                                                                \
-        if (MOCKC_CAT_(mockc_real_func_, n) == NULL) {                                                   \
+        if (MOCKC_CAT2_(mockc_real_func_, n, _singleton)() == NULL) {                                    \
             throw MockC_RealFunctionNotFound(__FILE__, MOCKC_TO_STRING_(__LINE__), MOCKC_TO_STRING_(n)); \
         }                                                                                                \
-        return MOCKC_CAT_(mockc_real_func_, n)(MOCKC_CAT2_(MOCKC_REPEAT_, i, _)(MOCKC_ARG_, f));         \
+        return MOCKC_CAT2_(mockc_real_func_, n, _singleton)()(                                           \
+            MOCKC_CAT2_(MOCKC_REPEAT_, i, _)(MOCKC_ARG_, f));                                            \
     }                                                                                                    \
     struct MOCKC_CAT_(MockC_, n)
 #else
@@ -245,11 +246,11 @@ struct MockC_Singleton {
             return MOCKC_INSTANCE(n).n(                                                                         \
                 GMOCK_PP_REPEAT(GMOCK_INTERNAL_FORWARD_ARG, (GMOCK_INTERNAL_SIGNATURE(r, f)), i));              \
         }                                                                                                       \
-        if (MOCKC_CAT_(mockc_real_func_, n) == NULL) {                                                          \
+        if (MOCKC_CAT2_(mockc_real_func_, n, _singleton)() == NULL) {                                           \
             throw MockC_RealFunctionNotFound(__FILE__, MOCKC_TO_STRING_(__LINE__), MOCKC_TO_STRING_(n));        \
         }                                                                                                       \
-        return MOCKC_CAT_(mockc_real_func_,                                                                     \
-                          n)(GMOCK_PP_REPEAT(GMOCK_INTERNAL_FORWARD_ARG, (GMOCK_INTERNAL_SIGNATURE(r, f)), i)); \
+        return MOCKC_CAT2_(mockc_real_func_, n, _singleton)()(                                                  \
+            GMOCK_PP_REPEAT(GMOCK_INTERNAL_FORWARD_ARG, (GMOCK_INTERNAL_SIGNATURE(r, f)), i));                  \
     }                                                                                                           \
     struct MOCKC_CAT_(MockC_, n)
 #endif
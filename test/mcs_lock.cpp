@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "blet/mcs_lock.h"
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+struct Counter {
+    blet::McsLock lock;
+    long value;
+};
+
+static void increment(Counter* pCounter, int count) {
+    for (int i = 0; i < count; ++i) {
+        blet::LockGuard<blet::McsLock> guard(pCounter->lock);
+        long value = pCounter->value;
+        if (i % 64 == 0) {
+            // let the others queue and park
+            ::sched_yield();
+        }
+        pCounter->value = value + 1;
+    }
+}
+
+GTEST_TEST(mcsLock, lockUnlock) {
+    blet::McsLock lock;
+    lock.lock();
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+
+    blet::McsLock::Node node;
+    lock.lock(&node);
+    blet::McsLock::Node other;
+    EXPECT_FALSE(lock.try_lock(&other));
+    lock.unlock(&node);
+}
+
+GTEST_TEST(mcsLock, nested) {
+    blet::McsLock first;
+    blet::McsLock second;
+    {
+        blet::LockGuard<blet::McsLock> firstGuard(first);
+        blet::LockGuard<blet::McsLock> secondGuard(second);
+        EXPECT_FALSE(first.try_lock());
+        EXPECT_FALSE(second.try_lock());
+    }
+    EXPECT_TRUE(first.try_lock());
+    EXPECT_TRUE(second.try_lock());
+    second.unlock();
+    first.unlock();
+}
+
+GTEST_TEST(mcsLock, depth) {
+    blet::McsLock locks[BLET_MCS_LOCK_DEPTH + 1];
+    for (int i = 0; i < BLET_MCS_LOCK_DEPTH; ++i) {
+        EXPECT_TRUE(locks[i].try_lock());
+    }
+    // no node left in the cache
+    EXPECT_FALSE(locks[BLET_MCS_LOCK_DEPTH].try_lock());
+    for (int i = BLET_MCS_LOCK_DEPTH - 1; i >= 0; --i) {
+        locks[i].unlock();
+    }
+}
+
+GTEST_TEST(mcsLock, contended) {
+    Counter counter;
+    counter.value = 0;
+    std::vector<blet::Thread> threads(8);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&increment, &counter, 10000);
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(counter.value, 80000);
+}
+
+struct Queue {
+    blet::McsLock lock;
+    int queued;
+    std::vector<int> order;
+};
+
+static void enqueue(Queue* pQueue, int id) {
+    __atomic_add_fetch(&pQueue->queued, 1, __ATOMIC_RELEASE);
+    blet::LockGuard<blet::McsLock> guard(pQueue->lock);
+    pQueue->order.push_back(id);
+}
+
+GTEST_TEST(mcsLock, fifo) {
+    Queue queue;
+    queue.queued = 0;
+    queue.lock.lock();
+    std::vector<blet::Thread> threads(4);
+    for (int i = 0; i < 4; ++i) {
+        threads[i].start(&enqueue, &queue, i);
+        while (__atomic_load_n(&queue.queued, __ATOMIC_ACQUIRE) != i + 1) {
+            ::sched_yield();
+        }
+        // long enough to swap the tail and park
+        ::usleep(10000);
+    }
+    queue.lock.unlock();
+    for (int i = 0; i < 4; ++i) {
+        threads[i].join();
+    }
+    ASSERT_EQ(queue.order.size(), 4U);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(queue.order[i], i);
+    }
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <string>
 #include <vector>
 
 #include "blet/thread.h"
@@ -148,3 +149,52 @@ GTEST_TEST(thread, methodArg2Const) {
     EXPECT_EQ(t.resultMethodArgsConst[0], 1);
     EXPECT_EQ(t.resultMethodArgsConst[1], 2);
 }
+
+struct LargeArg {
+    int values[128];
+};
+
+static void staticMethodString(std::string str, std::string* result) {
+    *result = str;
+}
+
+static void staticMethodStringSize(std::string str, int* result) {
+    __atomic_store_n(result, static_cast<int>(str.size()), __ATOMIC_RELEASE);
+}
+
+static void staticMethodLargeArg(LargeArg arg, int* result) {
+    *result = arg.values[0] + arg.values[127];
+}
+
+GTEST_TEST(thread, staticMethodInlineArg) {
+    std::string result;
+    blet::Thread thrd;
+    thrd.start(&staticMethodString, std::string("inline"), &result);
+    thrd.join();
+    EXPECT_EQ(result, "inline");
+}
+
+GTEST_TEST(thread, staticMethodHeapArg) {
+    LargeArg arg;
+    arg.values[0] = 1;
+    arg.values[127] = 2;
+    int result = 0;
+    blet::Thread thrd;
+    thrd.start(&staticMethodLargeArg, arg, &result);
+    thrd.join();
+    EXPECT_EQ(result, 3);
+}
+
+GTEST_TEST(thread, staticMethodInlineArgDetached) {
+    int result = 0;
+    {
+        blet::Thread thrd(&staticMethodStringSize, std::string("detached"),
+                          &result);
+        thrd.detach();
+    }
+    for (int i = 0; i < 1000 && __atomic_load_n(&result, __ATOMIC_ACQUIRE) == 0;
+         ++i) {
+        usleep(1000);
+    }
+    EXPECT_EQ(__atomic_load_n(&result, __ATOMIC_ACQUIRE), 8);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "blet/mpmc_queue.h"
+#include "blet/thread.h"
+
+GTEST_TEST(mpmcQueue, capacity) {
+    blet::MpmcQueue<int> one(1);
+    EXPECT_EQ(one.capacity(), 2u);
+    blet::MpmcQueue<int> five(5);
+    EXPECT_EQ(five.capacity(), 8u);
+    blet::MpmcQueue<int> eight(8);
+    EXPECT_EQ(eight.capacity(), 8u);
+}
+
+GTEST_TEST(mpmcQueue, tryPushTryPop) {
+    blet::MpmcQueue<std::string> queue(4);
+    std::string value;
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_EQ(queue.size(), 0u);
+    for (int round = 0; round < 3; ++round) {
+        EXPECT_TRUE(queue.try_push("a"));
+        EXPECT_TRUE(queue.try_push("b"));
+        EXPECT_TRUE(queue.try_push("c"));
+        EXPECT_TRUE(queue.try_push("d"));
+        EXPECT_FALSE(queue.try_push("e"));
+        EXPECT_EQ(queue.size(), 4u);
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "a");
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "b");
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "c");
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "d");
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+}
+
+static void produce(blet::MpmcQueue<int>* pQueue, int count) {
+    for (int i = 1; i <= count; ++i) {
+        pQueue->push(i);
+    }
+}
+
+static void consume(blet::MpmcQueue<int>* pQueue, long* pSum, int count) {
+    long sum = 0;
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        pQueue->pop(value);
+        sum += value;
+    }
+    __atomic_fetch_add(pSum, sum, __ATOMIC_RELAXED);
+}
+
+GTEST_TEST(mpmcQueue, producersConsumers) {
+    const int count = 50000;
+    // small capacity so both sides block
+    blet::MpmcQueue<int> queue(4);
+    long sum = 0;
+    blet::Thread producers[4];
+    blet::Thread consumers[4];
+    for (int i = 0; i < 4; ++i) {
+        consumers[i].start(&consume, &queue, &sum, count);
+        producers[i].start(&produce, &queue, count);
+    }
+    for (int i = 0; i < 4; ++i) {
+        producers[i].join();
+        consumers[i].join();
+    }
+    EXPECT_EQ(sum, 4L * count * (count + 1) / 2);
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+GTEST_TEST(mpmcQueue, popWaits) {
+    blet::MpmcQueue<int> queue(2);
+    long sum = 0;
+    blet::Thread consumer(&consume, &queue, &sum, 2);
+    // let the consumer park
+    ::usleep(50000);
+    queue.push(40);
+    ::usleep(50000);
+    queue.push(2);
+    consumer.join();
+    EXPECT_EQ(sum, 42);
+}
+
+GTEST_TEST(mpmcQueue, pushWaits) {
+    blet::MpmcQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+    blet::Thread producer(&produce, &queue, 2);
+    // let the producer park
+    ::usleep(50000);
+    int value = 0;
+    queue.pop(value);
+    EXPECT_EQ(value, 1);
+    queue.pop(value);
+    EXPECT_EQ(value, 2);
+    producer.join();
+    queue.pop(value);
+    EXPECT_EQ(value, 1);
+    queue.pop(value);
+    EXPECT_EQ(value, 2);
+}
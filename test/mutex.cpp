@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "blet/mutex.h"
+#include "blet/thread.h"
+
+struct Counter {
+    blet::Mutex mutex;
+    long value;
+};
+
+static void increment(Counter* pCounter, int count) {
+    for (int i = 0; i < count; ++i) {
+        blet::LockGuard<blet::Mutex> guard(pCounter->mutex);
+        long value = pCounter->value;
+        if (i % 64 == 0) {
+            // let the others contend and park
+            ::sched_yield();
+        }
+        pCounter->value = value + 1;
+    }
+}
+
+GTEST_TEST(mutex, lockUnlock) {
+    blet::Mutex mutex;
+    mutex.lock();
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    {
+        blet::LockGuard<blet::Mutex> guard(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    blet::cpu_relax();
+}
+
+GTEST_TEST(mutex, contended) {
+    Counter counter;
+    counter.value = 0;
+    std::vector<blet::Thread> threads(8);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&increment, &counter, 10000);
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(counter.value, 80000);
+}
+
+static void holdLock(blet::Mutex* pMutex, int* pLocked) {
+    pMutex->lock();
+    __atomic_store_n(pLocked, 1, __ATOMIC_RELEASE);
+    // long enough for the main thread to park
+    ::usleep(20000);
+    pMutex->unlock();
+}
+
+GTEST_TEST(mutex, park) {
+    blet::Mutex mutex;
+    int locked = 0;
+    blet::Thread thrd(&holdLock, &mutex, &locked);
+    while (__atomic_load_n(&locked, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+    mutex.lock();
+    mutex.unlock();
+    thrd.join();
+}
+
+struct Recorder {
+    void lock() {
+        ++locks;
+    }
+    void unlock() {
+        ++unlocks;
+    }
+    int locks;
+    int unlocks;
+};
+
+GTEST_TEST(mutex, lockGuard) {
+    Recorder recorder = {0, 0};
+    {
+        blet::LockGuard<Recorder> guard(recorder);
+        EXPECT_EQ(recorder.locks, 1);
+        EXPECT_EQ(recorder.unlocks, 0);
+    }
+    EXPECT_EQ(recorder.unlocks, 1);
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include <ftw.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "blet/mockc.h"
+#include "blet/numa_pool.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+static void writeFile(const std::string& path, const char* value) {
+    std::FILE* pFile = std::fopen(path.c_str(), "w");
+    ASSERT_TRUE(pFile != NULL);
+    std::fputs(value, pFile);
+    std::fclose(pFile);
+}
+
+static int removeEntry(const char* path, const struct stat*, int,
+                       struct FTW*) {
+    return ::remove(path);
+}
+
+// node 0 and 1 on cpu 0, node 2 without CPU, node 3 offline
+class FakeNodes : public ::testing::Test {
+  protected:
+    void SetUp() {
+        char dir[] = "/tmp/blet_numa_XXXXXX";
+        ASSERT_TRUE(::mkdtemp(dir) != NULL);
+        root_ = dir;
+        writeFile(root_ + "/online", "0-2\n");
+        const char* cpulists[] = {"0\n", "0\n", "\n", "0\n"};
+        for (int i = 0; i < 4; ++i) {
+            char name[16];
+            std::sprintf(name, "/node%d", i);
+            ::mkdir((root_ + name).c_str(), 0700);
+            writeFile(root_ + name + "/cpulist", cpulists[i]);
+        }
+    }
+
+    void TearDown() {
+        ::nftw(root_.c_str(), &removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string root_;
+};
+
+static void recordNode(int* pNodes) {
+    __atomic_fetch_add(&pNodes[blet::NumaPool::current_node()], 1,
+                       __ATOMIC_RELAXED);
+}
+
+static void submitRecordNode(blet::NumaPool* pPool, int* pNodes) {
+    pPool->submit(&recordNode, pNodes);
+}
+
+static void increment(int* pCount) {
+    __atomic_fetch_add(pCount, 1, __ATOMIC_RELAXED);
+}
+
+static void block(int* pFlag) {
+    while (__atomic_load_n(pFlag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+static void throwError(const char* message) {
+    throw std::runtime_error(message);
+}
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+
+GTEST_TEST(numaPool, withoutSysfs) {
+    cpu_set_t allowed;
+    ::sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    blet::NumaPool pool(0, "/nonexistent/blet/node");
+    EXPECT_EQ(pool.node_count(), 1U);
+    EXPECT_EQ(pool.node_id(0), 0);
+    EXPECT_EQ(pool.size(), static_cast<std::size_t>(CPU_COUNT(&allowed)));
+    EXPECT_TRUE(CPU_EQUAL(&pool.node_cpus(0), &allowed));
+    EXPECT_EQ(blet::NumaPool::current_node(), -1);
+
+    int count = 0;
+    for (int i = 0; i < 100; ++i) {
+        pool.submit(&increment, &count);
+    }
+    pool.wait();
+    EXPECT_EQ(count, 100);
+    blet::NumaPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.localTasks, 100U);
+    EXPECT_EQ(stats.remoteTasks, 0U);
+}
+
+TEST_F(FakeNodes, nodes) {
+    blet::NumaPool pool(2, root_.c_str());
+    ASSERT_EQ(pool.node_count(), 2U);
+    EXPECT_EQ(pool.size(), 4U);
+    EXPECT_EQ(pool.node_id(0), 0);
+    EXPECT_EQ(pool.node_id(1), 1);
+    EXPECT_EQ(CPU_COUNT(&pool.node_cpus(1)), 1);
+    EXPECT_TRUE(CPU_ISSET(0, &pool.node_cpus(1)));
+
+    int nodes[2] = {0, 0};
+    for (int i = 0; i < 100; ++i) {
+        pool.node(1).submit(&recordNode, nodes);
+    }
+    pool.wait();
+    blet::NumaPool::Stats stats = pool.stats();
+    EXPECT_EQ(nodes[0] + nodes[1], 100);
+    EXPECT_EQ(stats.localTasks, static_cast<unsigned long>(nodes[1]));
+    EXPECT_EQ(stats.remoteTasks, static_cast<unsigned long>(nodes[0]));
+}
+
+TEST_F(FakeNodes, steal) {
+    blet::NumaPool pool(1, root_.c_str());
+    ASSERT_EQ(pool.size(), 2U);
+
+    // the worker running block is busy, the other one runs the increments
+    int flag = 0;
+    int count = 0;
+    pool.node(1).submit(&block, &flag);
+    for (int i = 0; i < 10; ++i) {
+        pool.node(1).submit(&increment, &count);
+    }
+    while (__atomic_load_n(&count, __ATOMIC_RELAXED) != 10) {
+        ::sched_yield();
+    }
+    __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+    pool.wait();
+    EXPECT_GE(pool.stats().remoteTasks, 1U);
+}
+
+static void signalBlock(int* pFlags) {
+    __atomic_store_n(&pFlags[0], 1, __ATOMIC_RELEASE);
+    block(&pFlags[1]);
+}
+
+TEST_F(FakeNodes, wakeOtherNode) {
+    blet::NumaPool pool(1, root_.c_str());
+    // both workers park
+    ::usleep(50000);
+    int flags[2] = {0, 0};
+    pool.node(0).submit(&signalBlock, flags);
+    block(&flags[0]);
+    // the worker of node 0 is busy, the parked worker of node 1 is woken
+    int count = 0;
+    pool.node(0).submit(&increment, &count);
+    while (__atomic_load_n(&count, __ATOMIC_RELAXED) != 1) {
+        ::sched_yield();
+    }
+    __atomic_store_n(&flags[1], 1, __ATOMIC_RELEASE);
+    pool.wait();
+}
+
+TEST_F(FakeNodes, submitFromWorker) {
+    blet::NumaPool pool(1, root_.c_str());
+    int nodes[2] = {0, 0};
+    // a worker submits to its own node
+    pool.node(1).submit(&submitRecordNode, &pool, nodes);
+    pool.wait();
+    EXPECT_EQ(nodes[0] + nodes[1], 1);
+}
+
+TEST_F(FakeNodes, exception) {
+    blet::NumaPool pool(1, root_.c_str());
+    pool.node(0).submit(&throwError, "first");
+    pool.node(0).submit(&throwError, "second");
+    EXPECT_THROW(pool.wait(), std::exception);
+    // rethrown once
+    pool.wait();
+}
+
+GTEST_TEST(numaPool, allocateOnNode) {
+    const std::size_t size = 1024 * 1024;
+    char* pMemory =
+        static_cast<char*>(blet::NumaPool::allocate_on_node(size, 0));
+    ASSERT_TRUE(pMemory != NULL);
+    std::memset(pMemory, 1, size);
+    EXPECT_EQ(pMemory[size - 1], 1);
+    blet::NumaPool::deallocate_on_node(pMemory, size);
+
+    pMemory = static_cast<char*>(blet::NumaPool::allocate_on_node(size, -1));
+    ASSERT_TRUE(pMemory != NULL);
+    pMemory[0] = 1;
+    blet::NumaPool::deallocate_on_node(pMemory, size);
+
+    EXPECT_TRUE(blet::NumaPool::allocate_on_node(0, 0) == NULL);
+}
+
+GTEST_TEST(numaPool, createException) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            blet::NumaPool pool(1, "/nonexistent/blet/node");
+        },
+        blet::Thread::Exception);
+}
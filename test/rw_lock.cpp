@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <vector>
+
+#include "blet/mutex.h"
+#include "blet/rw_lock.h"
+#include "blet/thread.h"
+
+GTEST_TEST(rwLock, slots) {
+    blet::RwLock lock;
+    EXPECT_GE(lock.slot_count(), 1U);
+    blet::RwLock single(1);
+    EXPECT_EQ(single.slot_count(), 1U);
+}
+
+GTEST_TEST(rwLock, lockUnlock) {
+    blet::RwLock lock(4);
+    lock.lock_shared();
+    // readers share the lock, writers are kept out
+    EXPECT_TRUE(lock.try_lock_shared());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock_shared();
+    lock.unlock_shared();
+
+    lock.lock();
+    EXPECT_FALSE(lock.try_lock_shared());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+    {
+        blet::SharedLockGuard<blet::RwLock> guard(lock);
+        EXPECT_FALSE(lock.try_lock());
+    }
+    {
+        blet::LockGuard<blet::RwLock> guard(lock);
+        EXPECT_FALSE(lock.try_lock_shared());
+    }
+    EXPECT_TRUE(lock.try_lock_shared());
+    lock.unlock_shared();
+}
+
+// the writer keeps both fields equal
+struct Table {
+    Table() :
+        lock(2),
+        first(0),
+        second(0),
+        torn(0) {}
+    blet::RwLock lock;
+    long first;
+    long second;
+    int torn;
+};
+
+static void readTable(Table* pTable, int count) {
+    for (int i = 0; i < count; ++i) {
+        blet::SharedLockGuard<blet::RwLock> guard(pTable->lock);
+        long first = pTable->first;
+        if (i % 64 == 0) {
+            ::sched_yield();
+        }
+        if (pTable->second != first) {
+            __atomic_add_fetch(&pTable->torn, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void writeTable(Table* pTable, int count) {
+    for (int i = 0; i < count; ++i) {
+        blet::LockGuard<blet::RwLock> guard(pTable->lock);
+        ++pTable->first;
+        ::sched_yield();
+        ++pTable->second;
+    }
+}
+
+GTEST_TEST(rwLock, contended) {
+    Table table;
+    std::vector<blet::Thread> threads(6);
+    for (std::size_t i = 0; i < 4; ++i) {
+        threads[i].start(&readTable, &table, 20000);
+    }
+    threads[4].start(&writeTable, &table, 500);
+    threads[5].start(&writeTable, &table, 500);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(table.torn, 0);
+    EXPECT_EQ(table.first, 1000);
+    EXPECT_EQ(table.second, 1000);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <vector>
+
+#include "blet/seq_lock.h"
+#include "blet/thread.h"
+
+// 256 bytes, every word holds the same value
+struct Snapshot {
+    long values[256 / sizeof(long)];
+};
+
+static Snapshot makeSnapshot(long value) {
+    Snapshot snapshot;
+    for (std::size_t i = 0; i < sizeof(snapshot.values) / sizeof(long); ++i) {
+        snapshot.values[i] = value;
+    }
+    return snapshot;
+}
+
+struct Shared {
+    blet::SeqLock<Snapshot> snapshot;
+    int stop;
+    int torn;
+};
+
+static void readSnapshot(Shared* pShared) {
+    long last = 0;
+    while (__atomic_load_n(&pShared->stop, __ATOMIC_ACQUIRE) == 0) {
+        Snapshot snapshot = pShared->snapshot.load();
+        for (std::size_t i = 1; i < sizeof(snapshot.values) / sizeof(long);
+             ++i) {
+            if (snapshot.values[i] != snapshot.values[0]) {
+                __atomic_add_fetch(&pShared->torn, 1, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+        // never older than a previous read
+        if (snapshot.values[0] < last) {
+            __atomic_add_fetch(&pShared->torn, 1, __ATOMIC_RELAXED);
+        }
+        last = snapshot.values[0];
+        ::sched_yield();
+    }
+}
+
+GTEST_TEST(seqLock, loadStore) {
+    blet::SeqLock<Snapshot> snapshot;
+    EXPECT_EQ(snapshot.load().values[0], 0);
+    EXPECT_EQ(snapshot.version(), 0U);
+    snapshot.store(makeSnapshot(42));
+    EXPECT_EQ(snapshot.load().values[31], 42);
+    EXPECT_EQ(snapshot.version(), 1U);
+
+    blet::SeqLock<int> value(7);
+    EXPECT_EQ(value.load(), 7);
+    value.store(8);
+    EXPECT_EQ(value.load(), 8);
+}
+
+struct Odd {
+    char bytes[13];
+};
+
+GTEST_TEST(seqLock, oddSize) {
+    Odd odd;
+    for (int i = 0; i < 13; ++i) {
+        odd.bytes[i] = static_cast<char>(i);
+    }
+    blet::SeqLock<Odd> seqLock(odd);
+    Odd copy = seqLock.load();
+    EXPECT_EQ(copy.bytes[12], 12);
+}
+
+GTEST_TEST(seqLock, concurrent) {
+    Shared shared;
+    shared.stop = 0;
+    shared.torn = 0;
+    std::vector<blet::Thread> readers(4);
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        readers[i].start(&readSnapshot, &shared);
+    }
+    for (long value = 1; value <= 100000; ++value) {
+        shared.snapshot.store(makeSnapshot(value));
+        if (value % 256 == 0) {
+            ::sched_yield();
+        }
+    }
+    __atomic_store_n(&shared.stop, 1, __ATOMIC_RELEASE);
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        readers[i].join();
+    }
+    EXPECT_EQ(shared.torn, 0);
+    EXPECT_EQ(shared.snapshot.load().values[0], 100000);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <string>
+
+#include "blet/spsc_queue.h"
+#include "blet/thread.h"
+
+GTEST_TEST(spscQueue, capacity) {
+    blet::SpscQueue<int> one(1);
+    EXPECT_EQ(one.capacity(), 1u);
+    blet::SpscQueue<int> five(5);
+    EXPECT_EQ(five.capacity(), 8u);
+}
+
+GTEST_TEST(spscQueue, tryPushTryPop) {
+    blet::SpscQueue<std::string> queue(2);
+    std::string value;
+    EXPECT_FALSE(queue.try_pop(value));
+    for (int round = 0; round < 3; ++round) {
+        EXPECT_TRUE(queue.try_push("a"));
+        EXPECT_TRUE(queue.try_push("b"));
+        EXPECT_FALSE(queue.try_push("c"));
+        EXPECT_EQ(queue.size(), 2u);
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "a");
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, "b");
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+}
+
+GTEST_TEST(spscQueue, pushNPopN) {
+    blet::SpscQueue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10] = {0};
+    // move the indices so the next spans wrap around the end
+    EXPECT_EQ(queue.push_n(in, 5), 5u);
+    EXPECT_EQ(queue.pop_n(out, 5), 5u);
+    EXPECT_EQ(queue.push_n(in, 10), 8u);
+    EXPECT_EQ(queue.push_n(in, 1), 0u);
+    EXPECT_EQ(queue.pop_n(out, 3), 3u);
+    EXPECT_EQ(queue.push_n(in + 8, 2), 2u);
+    EXPECT_EQ(queue.pop_n(out + 3, 10), 7u);
+    EXPECT_EQ(queue.pop_n(out, 1), 0u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+}
+
+static void produce(blet::SpscQueue<int>* pQueue, int count) {
+    int values[7];
+    int next = 0;
+    while (next < count) {
+        if (next % 2 == 0) {
+            int size = 0;
+            while (size < 7 && next + size < count) {
+                values[size] = next + size;
+                ++size;
+            }
+            next += static_cast<int>(pQueue->push_n(values, size));
+        }
+        else if (pQueue->try_push(next)) {
+            ++next;
+        }
+        else {
+            ::sched_yield();
+        }
+    }
+}
+
+GTEST_TEST(spscQueue, producerConsumer) {
+    const int count = 1000000;
+    blet::SpscQueue<int> queue(64);
+    blet::Thread producer(&produce, &queue, count);
+    int values[5];
+    int expected = 0;
+    bool isOrdered = true;
+    while (expected < count) {
+        std::size_t size = queue.pop_n(values, 5);
+        for (std::size_t i = 0; i < size; ++i) {
+            isOrdered = isOrdered && values[i] == expected;
+            ++expected;
+        }
+        int value = 0;
+        if (queue.try_pop(value)) {
+            isOrdered = isOrdered && value == expected;
+            ++expected;
+        }
+        else {
+            ::sched_yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(isOrdered);
+    EXPECT_EQ(queue.size(), 0u);
+}
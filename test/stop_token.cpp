@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#include "blet/stop_token.h"
+#include "blet/thread.h"
+#include "blet/thread_pool.h"
+
+static void scan(blet::StopToken token, int* pCount) {
+    while (!token.stop_requested()) {
+        __atomic_add_fetch(pCount, 1, __ATOMIC_RELAXED);
+        ::sched_yield();
+    }
+}
+
+static void waitStop(blet::StopToken token, int* pDone) {
+    token.wait();
+    __atomic_store_n(pDone, 1, __ATOMIC_RELEASE);
+}
+
+static void increment(void* data) {
+    ++*static_cast<int*>(data);
+}
+
+GTEST_TEST(stopToken, withoutSource) {
+    blet::StopToken token;
+    EXPECT_FALSE(token.stop_possible());
+    EXPECT_FALSE(token.stop_requested());
+    EXPECT_FALSE(token.wait_for(1));
+
+    int count = 0;
+    blet::StopCallback callback(token, &increment, &count);
+    EXPECT_EQ(count, 0);
+}
+
+GTEST_TEST(stopToken, requestStop) {
+    blet::StopSource source;
+    blet::StopToken token = source.get_token();
+    EXPECT_TRUE(token.stop_possible());
+    EXPECT_FALSE(token.stop_requested());
+    EXPECT_FALSE(source.stop_requested());
+    EXPECT_TRUE(source.request_stop());
+    EXPECT_FALSE(source.request_stop());
+    EXPECT_TRUE(token.stop_requested());
+    EXPECT_TRUE(source.stop_requested());
+    token.wait();
+    EXPECT_TRUE(token.wait_for(1));
+}
+
+GTEST_TEST(stopToken, copy) {
+    blet::StopSource source;
+    blet::StopSource copySource(source);
+    blet::StopSource otherSource;
+    otherSource = source;
+    blet::StopToken token(source.get_token());
+    blet::StopToken otherToken;
+    otherToken = token;
+    otherToken = otherToken;
+    copySource.request_stop();
+    EXPECT_TRUE(otherSource.stop_requested());
+    EXPECT_TRUE(otherToken.stop_requested());
+}
+
+GTEST_TEST(stopToken, thread) {
+    blet::StopSource source;
+    int count = 0;
+    blet::Thread thrd(&scan, source.get_token(), &count);
+    while (__atomic_load_n(&count, __ATOMIC_RELAXED) == 0) {
+        ::sched_yield();
+    }
+    source.request_stop();
+    thrd.join();
+}
+
+GTEST_TEST(stopToken, threadPool) {
+    blet::StopSource source;
+    int counts[4] = {0, 0, 0, 0};
+    blet::ThreadPool pool(4);
+    for (int i = 0; i < 4; ++i) {
+        pool.submit(&scan, source.get_token(), &counts[i]);
+    }
+    source.request_stop();
+    pool.wait();
+}
+
+GTEST_TEST(stopToken, wait) {
+    blet::StopSource source;
+    int done = 0;
+    blet::Thread thrd(&waitStop, source.get_token(), &done);
+    EXPECT_FALSE(source.get_token().wait_for(10));
+    EXPECT_EQ(__atomic_load_n(&done, __ATOMIC_ACQUIRE), 0);
+    source.request_stop();
+    thrd.join();
+    EXPECT_EQ(done, 1);
+}
+
+GTEST_TEST(stopToken, waitFor) {
+    blet::StopSource source;
+    int done = 0;
+    blet::Thread thrd(&waitStop, source.get_token(), &done);
+    // woken by the request
+    source.request_stop();
+    EXPECT_TRUE(source.get_token().wait_for(10000));
+    thrd.join();
+}
+
+GTEST_TEST(stopToken, callback) {
+    blet::StopSource source;
+    int count = 0;
+    int unregistered = 0;
+    {
+        blet::StopCallback first(source.get_token(), &increment, &count);
+        blet::StopCallback second(source.get_token(), &increment, &count);
+        {
+            blet::StopCallback third(source.get_token(), &increment,
+                                     &unregistered);
+        }
+        blet::StopCallback fourth(source.get_token(), &increment, &count);
+        EXPECT_EQ(count, 0);
+        source.request_stop();
+        EXPECT_EQ(count, 3);
+        EXPECT_EQ(unregistered, 0);
+        source.request_stop();
+        EXPECT_EQ(count, 3);
+    }
+    // already requested, run at once
+    blet::StopCallback late(source.get_token(), &increment, &count);
+    EXPECT_EQ(count, 4);
+}
+
+static void destroySelf(void* data) {
+    delete *static_cast<blet::StopCallback**>(data);
+}
+
+GTEST_TEST(stopToken, callbackDestroySelf) {
+    blet::StopSource source;
+    blet::StopCallback* pCallback = NULL;
+    pCallback = new blet::StopCallback(source.get_token(), &destroySelf,
+                                       &pCallback);
+    source.request_stop();
+}
+
+struct Slow {
+    int entered;
+    int finished;
+};
+
+static void slowCallback(void* data) {
+    Slow* pSlow = static_cast<Slow*>(data);
+    __atomic_store_n(&pSlow->entered, 1, __ATOMIC_RELEASE);
+    ::usleep(20000);
+    __atomic_store_n(&pSlow->finished, 1, __ATOMIC_RELEASE);
+}
+
+static void requestStop(blet::StopSource* pSource) {
+    pSource->request_stop();
+}
+
+GTEST_TEST(stopToken, callbackDestroyWhileRunning) {
+    blet::StopSource source;
+    Slow slow = {0, 0};
+    blet::StopCallback* pCallback =
+        new blet::StopCallback(source.get_token(), &slowCallback, &slow);
+    blet::Thread thrd(&requestStop, &source);
+    while (__atomic_load_n(&slow.entered, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+    // waits for the call running in the other thread
+    delete pCallback;
+    EXPECT_EQ(__atomic_load_n(&slow.finished, __ATOMIC_ACQUIRE), 1);
+    thrd.join();
+}
@@ -0,0 +1,486 @@
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "blet/mockc.h"
+#include "blet/thread.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+struct StackInfo {
+    void* pStack;
+    std::size_t stackSize;
+    std::size_t guardSize;
+    int policy;
+    bool isCpu0;
+    int cpuCount;
+};
+
+static void readStackInfo(StackInfo* pInfo) {
+    pthread_attr_t attr;
+    ::pthread_getattr_np(::pthread_self(), &attr);
+    ::pthread_attr_getstack(&attr, &pInfo->pStack, &pInfo->stackSize);
+    ::pthread_attr_getguardsize(&attr, &pInfo->guardSize);
+    ::pthread_attr_destroy(&attr);
+    sched_param param;
+    ::pthread_getschedparam(::pthread_self(), &pInfo->policy, &param);
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    ::pthread_getaffinity_np(::pthread_self(), sizeof(cpus), &cpus);
+    pInfo->isCpu0 = CPU_ISSET(0, &cpus);
+    pInfo->cpuCount = CPU_COUNT(&cpus);
+}
+
+static void nothing() {}
+
+static void setFlag(int* pFlag) {
+    __atomic_store_n(pFlag, 1, __ATOMIC_RELEASE);
+}
+
+static std::size_t pageSize() {
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+// count the pages of the stack not in memory
+static void countMissingPages(std::size_t* pMissing) {
+    pthread_attr_t attr;
+    void* pStack = NULL;
+    std::size_t stackSize = 0;
+    ::pthread_getattr_np(::pthread_self(), &attr);
+    ::pthread_attr_getstack(&attr, &pStack, &stackSize);
+    ::pthread_attr_destroy(&attr);
+    std::vector<unsigned char> pages(stackSize / pageSize());
+    ::mincore(pStack, stackSize, &pages[0]);
+    *pMissing = 0;
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        *pMissing += (pages[i] & 1) == 0;
+    }
+}
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+MOCKC_ATTRIBUTE_METHOD2(int, mlock, (const void* __addr, size_t __len),
+                        throw());
+
+GTEST_TEST(threadAttributes, defaultValues) {
+    blet::Thread::Attributes attributes;
+    EXPECT_EQ(attributes.stack_size(), 0U);
+    EXPECT_EQ(attributes.guard_size(), 0U);
+    EXPECT_FALSE(attributes.detached());
+    EXPECT_EQ(attributes.policy(), 0);
+    EXPECT_EQ(attributes.priority(), 0);
+    EXPECT_TRUE(attributes.affinity() == NULL);
+    EXPECT_FALSE(attributes.stack_cache());
+
+    blet::Thread thrd;
+    EXPECT_EQ(thrd.attributes().stack_size(), 0U);
+    StackInfo info;
+    thrd.start(&readStackInfo, &info);
+    thrd.join();
+    EXPECT_GT(info.stackSize, 0U);
+}
+
+GTEST_TEST(threadAttributes, stackSize) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(256 * 1024);
+    attributes.set_guard_size(2 * pageSize());
+    EXPECT_EQ(attributes.stack_size(), 256U * 1024U);
+    EXPECT_EQ(attributes.guard_size(), 2 * pageSize());
+
+    blet::Thread thrd(attributes);
+    StackInfo info;
+    thrd.start(&readStackInfo, &info);
+    thrd.join();
+    EXPECT_EQ(info.stackSize, 256U * 1024U);
+    EXPECT_EQ(info.guardSize, 2 * pageSize());
+}
+
+GTEST_TEST(threadAttributes, detached) {
+    blet::Thread::Attributes attributes;
+    attributes.set_detached(true);
+    // a detached thread never uses the cache
+    attributes.set_stack_cache(true);
+    EXPECT_TRUE(attributes.detached());
+
+    int flag = 0;
+    blet::Thread thrd;
+    thrd.set_attributes(attributes);
+    thrd.start(&setFlag, &flag);
+    EXPECT_FALSE(thrd.joinable());
+    EXPECT_THROW(thrd.join(), blet::Thread::Exception);
+    while (__atomic_load_n(&flag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+GTEST_TEST(threadAttributes, scheduling) {
+    blet::Thread::Attributes attributes;
+    attributes.set_scheduling(SCHED_OTHER, 0);
+    EXPECT_EQ(attributes.policy(), SCHED_OTHER);
+    EXPECT_EQ(attributes.priority(), 0);
+
+    blet::Thread thrd(attributes);
+    StackInfo info;
+    thrd.start(&readStackInfo, &info);
+    thrd.join();
+    EXPECT_EQ(info.policy, SCHED_OTHER);
+}
+
+GTEST_TEST(threadAttributes, invalidScheduling) {
+    blet::Thread::Attributes attributes;
+    blet::Thread thrd;
+
+    attributes.set_scheduling(-1, 0);
+    thrd.set_attributes(attributes);
+    EXPECT_THROW(thrd.start(&nothing), blet::Thread::Exception);
+
+    // SCHED_OTHER only accepts the priority 0
+    attributes.set_scheduling(SCHED_OTHER, 50);
+    thrd.set_attributes(attributes);
+    EXPECT_THROW(thrd.start(&nothing), blet::Thread::Exception);
+    EXPECT_FALSE(thrd.joinable());
+}
+
+GTEST_TEST(threadAttributes, affinity) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    blet::Thread::Attributes attributes;
+    attributes.set_affinity(cpus);
+    ASSERT_TRUE(attributes.affinity() != NULL);
+    EXPECT_TRUE(CPU_EQUAL(attributes.affinity(), &cpus));
+
+    blet::Thread thrd(attributes);
+    StackInfo info;
+    thrd.start(&readStackInfo, &info);
+    thrd.join();
+    EXPECT_TRUE(info.isCpu0);
+    EXPECT_EQ(info.cpuCount, 1);
+}
+
+GTEST_TEST(threadAttributes, stackCache) {
+    blet::Thread::Attributes attributes;
+    // size not used by the other tests
+    attributes.set_stack_size(192 * 1024 + 1);
+    attributes.set_stack_cache(true);
+    EXPECT_TRUE(attributes.stack_cache());
+
+    blet::StackCache::Stats before = blet::StackCache::stats();
+    blet::Thread thrd(attributes);
+    StackInfo first;
+    thrd.start(&readStackInfo, &first);
+    thrd.join();
+    StackInfo second;
+    thrd.start(&readStackInfo, &second);
+    thrd.join();
+    blet::StackCache::Stats after = blet::StackCache::stats();
+
+    // rounded up to the page size
+    EXPECT_EQ(first.stackSize % pageSize(), 0U);
+    EXPECT_GE(first.stackSize, 192U * 1024U + 1U);
+    EXPECT_EQ(first.pStack, second.pStack);
+    EXPECT_EQ(first.stackSize, second.stackSize);
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits + 1);
+}
+
+GTEST_TEST(threadAttributes, stackCacheDetach) {
+    blet::Thread::Attributes attributes;
+    // size not used by the other tests
+    attributes.set_stack_size(224 * 1024 + 1);
+    attributes.set_stack_cache(true);
+
+    blet::Thread thrd(attributes);
+    thrd.start(&nothing);
+    try {
+        thrd.detach();
+        FAIL();
+    }
+    catch (const blet::Thread::Exception& e) {
+        // the stack goes back to the cache on join
+        EXPECT_STREQ(e.what(), "Thread is not detachable");
+    }
+    EXPECT_TRUE(thrd.joinable());
+    thrd.join();
+
+    // once reaped, detach gives the stack back
+    thrd.start(&nothing);
+    while (!thrd.is_finished()) {
+        ::sched_yield();
+    }
+    thrd.detach();
+    EXPECT_FALSE(thrd.joinable());
+    blet::StackCache::Stats before = blet::StackCache::stats();
+    blet::Thread next(attributes);
+    next.start(&nothing);
+    next.join();
+    blet::StackCache::Stats after = blet::StackCache::stats();
+    EXPECT_EQ(after.hits, before.hits + 1);
+}
+
+GTEST_TEST(threadAttributes, stackCacheMapFailed) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(static_cast<std::size_t>(1) << 50);
+    attributes.set_stack_cache(true);
+
+    blet::Thread thrd(attributes);
+    try {
+        thrd.start(&nothing);
+        FAIL();
+    }
+    catch (const blet::Thread::Exception& e) {
+        EXPECT_STREQ(e.what(), "Failed to create thread");
+    }
+    EXPECT_FALSE(thrd.joinable());
+}
+
+GTEST_TEST(threadAttributes, invalidStackSize) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(1);
+
+    blet::Thread thrd(attributes);
+    EXPECT_THROW(thrd.start(&nothing), blet::Thread::Exception);
+    EXPECT_FALSE(thrd.joinable());
+}
+
+GTEST_TEST(threadAttributes, createException) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(128 * 1024 + 1);
+    attributes.set_stack_cache(true);
+
+    MOCKC_NEW_INSTANCE(pthread_create);
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+
+    blet::StackCache::Stats before = blet::StackCache::stats();
+    {
+        MOCKC_GUARD(pthread_create);
+        blet::Thread thrd(attributes);
+        EXPECT_THROW(thrd.start(&nothing), blet::Thread::Exception);
+    }
+    // the stack of the failed start went back to the cache
+    blet::Thread thrd(attributes);
+    thrd.start(&nothing);
+    thrd.join();
+    blet::StackCache::Stats after = blet::StackCache::stats();
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits + 1);
+}
+
+GTEST_TEST(threadAttributes, rawAttr) {
+    pthread_attr_t attr;
+    ::pthread_attr_init(&attr);
+    ::pthread_attr_setstacksize(&attr, 512 * 1024);
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(256 * 1024);
+
+    // set_attr wins over the Attributes
+    blet::Thread thrd(attributes);
+    thrd.set_attr(&attr);
+    StackInfo info;
+    thrd.start(&readStackInfo, &info);
+    thrd.join();
+    ::pthread_attr_destroy(&attr);
+    EXPECT_EQ(info.stackSize, 512U * 1024U);
+}
+
+GTEST_TEST(threadAttributes, persistent) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(96 * 1024);
+    attributes.set_stack_cache(true);
+    // ignored by the worker
+    attributes.set_detached(true);
+
+    StackInfo first;
+    StackInfo second;
+    {
+        blet::Thread thrd(attributes);
+        thrd.set_persistent(true);
+        thrd.start(&readStackInfo, &first);
+        EXPECT_TRUE(thrd.joinable());
+        thrd.join();
+        thrd.start(&readStackInfo, &second);
+        thrd.join();
+    }
+    EXPECT_EQ(first.stackSize, 96U * 1024U);
+    EXPECT_EQ(first.pStack, second.pStack);
+}
+
+GTEST_TEST(threadAttributes, lockStack) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(512 * 1024);
+    attributes.set_lock_stack(true);
+    EXPECT_TRUE(attributes.lock_stack());
+    EXPECT_FALSE(attributes.stack_cache());
+
+    // every page is faulted in before the thread runs
+    std::size_t missing = 1;
+    blet::Thread thrd(attributes);
+    thrd.start(&countMissingPages, &missing);
+    thrd.join();
+    EXPECT_EQ(missing, 0U);
+}
+
+GTEST_TEST(threadAttributes, lockStackDetached) {
+    blet::Thread::Attributes attributes;
+    attributes.set_lock_stack(true);
+    attributes.set_detached(true);
+
+    blet::Thread thrd(attributes);
+    try {
+        thrd.start(&nothing);
+        FAIL();
+    }
+    catch (const blet::Thread::Exception& e) {
+        EXPECT_STREQ(e.what(), "Detached thread cannot lock its stack");
+    }
+    EXPECT_FALSE(thrd.joinable());
+}
+
+GTEST_TEST(threadAttributes, lockStackDetach) {
+    blet::Thread::Attributes attributes;
+    attributes.set_lock_stack(true);
+
+    blet::Thread thrd(attributes);
+    thrd.start(&nothing);
+    EXPECT_THROW(thrd.detach(), blet::Thread::Exception);
+    EXPECT_TRUE(thrd.joinable());
+    thrd.join();
+}
+
+GTEST_TEST(threadAttributes, lockStackException) {
+    blet::Thread::Attributes attributes;
+    attributes.set_lock_stack(true);
+
+    MOCKC_NEW_INSTANCE(mlock);
+    EXPECT_CALL(MOCKC_INSTANCE(mlock), mlock(_, _)).WillOnce(Return(-1));
+
+    MOCKC_GUARD(mlock);
+    blet::Thread thrd(attributes);
+    try {
+        thrd.start(&nothing);
+        FAIL();
+    }
+    catch (const blet::Thread::Exception& e) {
+        EXPECT_STREQ(e.what(), "Failed to lock thread stack");
+    }
+    EXPECT_FALSE(thrd.joinable());
+}
+
+// attributes received by the mocked pthread_create and mlock
+struct RealtimeCall {
+    int inheritSched;
+    int policy;
+    int priority;
+    void* pStack;
+    std::size_t stackSize;
+    const void* pLocked;
+    std::size_t lockedSize;
+};
+
+static RealtimeCall realtimeCall;
+
+// record the attributes then create the thread without CAP_SYS_NICE
+static int createRealtime(pthread_t* pId, const pthread_attr_t* pAttr,
+                          void* (*pStart)(void*), void* data) {
+    sched_param param;
+    ::pthread_attr_getinheritsched(pAttr, &realtimeCall.inheritSched);
+    ::pthread_attr_getschedpolicy(pAttr, &realtimeCall.policy);
+    ::pthread_attr_getschedparam(pAttr, &param);
+    realtimeCall.priority = param.sched_priority;
+    ::pthread_attr_getstack(pAttr, &realtimeCall.pStack,
+                            &realtimeCall.stackSize);
+    pthread_attr_t attr;
+    ::pthread_attr_init(&attr);
+    ::pthread_attr_setstack(&attr, realtimeCall.pStack,
+                            realtimeCall.stackSize);
+    int result =
+        mockc_real_func_pthread_create_singleton()(pId, &attr, pStart, data);
+    ::pthread_attr_destroy(&attr);
+    return result;
+}
+
+static int lockRealtime(const void* pAddr, size_t len) {
+    realtimeCall.pLocked = pAddr;
+    realtimeCall.lockedSize = len;
+    return 0;
+}
+
+GTEST_TEST(threadAttributes, realtime) {
+    blet::Thread::Attributes attributes;
+    attributes.set_realtime(SCHED_FIFO, 10);
+    EXPECT_EQ(attributes.policy(), SCHED_FIFO);
+    EXPECT_EQ(attributes.priority(), 10);
+    EXPECT_TRUE(attributes.lock_stack());
+
+    MOCKC_NEW_INSTANCE(pthread_create);
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Invoke(&createRealtime));
+    MOCKC_NEW_INSTANCE(mlock);
+    EXPECT_CALL(MOCKC_INSTANCE(mlock), mlock(_, _))
+        .WillOnce(Invoke(&lockRealtime));
+
+    {
+        MOCKC_GUARD(pthread_create);
+        MOCKC_GUARD(mlock);
+        blet::Thread thrd(attributes);
+        thrd.start(&nothing);
+        thrd.join();
+    }
+    EXPECT_EQ(realtimeCall.inheritSched, PTHREAD_EXPLICIT_SCHED);
+    EXPECT_EQ(realtimeCall.policy, SCHED_FIFO);
+    EXPECT_EQ(realtimeCall.priority, 10);
+    // the whole stack given to the thread is locked
+    ASSERT_TRUE(realtimeCall.pStack != NULL);
+    EXPECT_EQ(realtimeCall.pLocked, realtimeCall.pStack);
+    EXPECT_EQ(realtimeCall.lockedSize, realtimeCall.stackSize);
+}
+
+GTEST_TEST(threadAttributes, realtimeNotPermitted) {
+    blet::Thread::Attributes attributes;
+    attributes.set_scheduling(SCHED_RR, 10);
+
+    MOCKC_NEW_INSTANCE(pthread_create);
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(EPERM));
+
+    MOCKC_GUARD(pthread_create);
+    blet::Thread thrd(attributes);
+    try {
+        thrd.start(&nothing);
+        FAIL();
+    }
+    catch (const blet::Thread::Exception& e) {
+        EXPECT_STREQ(e.what(), "Failed to set thread scheduling");
+    }
+}
+
+GTEST_TEST(threadAttributes, stackCacheFull) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(64 * 1024);
+    attributes.set_guard_size(0);
+    attributes.set_stack_cache(true);
+
+    // more threads than cached stacks, the extra ones are unmapped
+    // leaves the cache full for the next tests, keep it last
+    std::vector<blet::Thread> threads(BLET_THREAD_STACK_CACHE_SIZE + 4);
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].set_attributes(attributes);
+        threads[i].start(&nothing);
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].start(&nothing);
+    }
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "blet/thread.h"
+
+// larger than BLET_THREAD_INLINE_SIZE, counts the live copies
+struct Large {
+    Large() {
+        __atomic_add_fetch(&liveCount, 1, __ATOMIC_RELAXED);
+    }
+    Large(const Large&) {
+        __atomic_add_fetch(&liveCount, 1, __ATOMIC_RELAXED);
+    }
+    ~Large() {
+        __atomic_sub_fetch(&liveCount, 1, __ATOMIC_RELAXED);
+    }
+    char data[BLET_THREAD_INLINE_SIZE + 1];
+    static int liveCount;
+};
+
+int Large::liveCount = 0;
+
+static void blockForever(Large, int* pStarted) {
+    __atomic_store_n(pStarted, 1, __ATOMIC_RELEASE);
+    for (;;) {
+        ::pthread_testcancel();
+        ::sched_yield();
+    }
+}
+
+GTEST_TEST(threadCleanup, cancelHeapData) {
+    {
+        int started = 0;
+        blet::Thread thrd(&blockForever, Large(), &started);
+        while (__atomic_load_n(&started, __ATOMIC_ACQUIRE) == 0) {
+            ::sched_yield();
+        }
+        // the heap copy and the parameter
+        EXPECT_EQ(__atomic_load_n(&Large::liveCount, __ATOMIC_RELAXED), 2);
+        thrd.cancel();
+        thrd.join();
+    }
+    EXPECT_EQ(Large::liveCount, 0);
+}
+
+static void record(void* data) {
+    std::vector<int>* pOrder = static_cast<std::vector<int>*>(data);
+    pOrder->push_back(static_cast<int>(pOrder->size()));
+}
+
+static void recordAgain(void* data) {
+    record(data);
+    // registered during the exit, run by the next pass
+    blet::Thread::at_exit(&record, data);
+}
+
+static void registerHandlers(std::vector<int>* pOrder, int mode) {
+    blet::Thread::at_exit(&record, pOrder);
+    blet::Thread::at_exit(&recordAgain, pOrder);
+    if (mode == 1) {
+        throw std::runtime_error("registerHandlers");
+    }
+    if (mode == 2) {
+        for (;;) {
+            ::pthread_testcancel();
+            ::sched_yield();
+        }
+    }
+}
+
+GTEST_TEST(threadCleanup, atExitReturn) {
+    std::vector<int> order;
+    blet::Thread thrd(&registerHandlers, &order, 0);
+    thrd.join();
+    EXPECT_EQ(order.size(), 3U);
+}
+
+GTEST_TEST(threadCleanup, atExitException) {
+    std::vector<int> order;
+    blet::Thread thrd(&registerHandlers, &order, 1);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join(), std::runtime_error);
+#else
+    EXPECT_THROW(thrd.join(), blet::Thread::UncaughtException);
+#endif
+    EXPECT_EQ(order.size(), 3U);
+}
+
+GTEST_TEST(threadCleanup, atExitCancel) {
+    std::vector<int> order;
+    blet::Thread thrd(&registerHandlers, &order, 2);
+    thrd.cancel();
+    thrd.join();
+    EXPECT_EQ(order.size(), 3U);
+}
+
+struct Order {
+    int first;
+    int second;
+    int count;
+};
+
+static void setFirst(void* data) {
+    Order* pOrder = static_cast<Order*>(data);
+    pOrder->first = ++pOrder->count;
+}
+
+static void setSecond(void* data) {
+    Order* pOrder = static_cast<Order*>(data);
+    pOrder->second = ++pOrder->count;
+}
+
+static void registerOrder(Order* pOrder) {
+    blet::Thread::at_exit(&setFirst, pOrder);
+    blet::Thread::at_exit(&setSecond, pOrder);
+}
+
+GTEST_TEST(threadCleanup, atExitOrder) {
+    Order order = {0, 0, 0};
+    blet::Thread thrd(&registerOrder, &order);
+    thrd.join();
+    // last registered first
+    EXPECT_EQ(order.second, 1);
+    EXPECT_EQ(order.first, 2);
+}
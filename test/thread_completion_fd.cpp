@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "blet/thread.h"
+#include "blet/thread_group.h"
+
+static void block(int* pFlag) {
+    while (__atomic_load_n(pFlag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+static void throwError() {
+    throw std::runtime_error("throwError");
+}
+
+static void blockForever() {
+    for (;;) {
+        ::pthread_testcancel();
+        ::sched_yield();
+    }
+}
+
+// larger than BLET_THREAD_INLINE_SIZE
+struct Large {
+    char data[BLET_THREAD_INLINE_SIZE + 1];
+};
+
+static void large(Large) {}
+
+// slow to destroy, counts the live copies
+struct SlowDestroy {
+    explicit SlowDestroy(int* pLive) :
+        pLive_(pLive) {
+        __atomic_add_fetch(pLive_, 1, __ATOMIC_RELAXED);
+    }
+    SlowDestroy(const SlowDestroy& rhs) :
+        pLive_(rhs.pLive_) {
+        __atomic_add_fetch(pLive_, 1, __ATOMIC_RELAXED);
+    }
+    ~SlowDestroy() {
+        ::usleep(1000);
+        __atomic_sub_fetch(pLive_, 1, __ATOMIC_RELEASE);
+    }
+    int* pLive_;
+};
+
+static void slowDestroy(SlowDestroy, int* pFlag) {
+    block(pFlag);
+}
+
+// wait in epoll like an event loop then read the counter
+static uint64_t waitCompletion(int fd) {
+    int epollFd = ::epoll_create1(0);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    int count = ::epoll_wait(epollFd, &event, 1, 10000);
+    ::close(epollFd);
+    if (count != 1) {
+        return 0;
+    }
+    uint64_t value = 0;
+    if (::read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+static bool isSignaled(int fd) {
+    uint64_t value = 0;
+    return ::read(fd, &value, sizeof(value)) == sizeof(value);
+}
+
+class CompletionFd : public ::testing::Test {
+  protected:
+    void SetUp() {
+        fd_ = ::eventfd(0, EFD_NONBLOCK);
+        ASSERT_NE(fd_, -1);
+        attributes_.set_completion_fd(fd_);
+    }
+
+    void TearDown() {
+        ::close(fd_);
+    }
+
+    int fd_;
+    blet::Thread::Attributes attributes_;
+};
+
+TEST_F(CompletionFd, attributes) {
+    EXPECT_EQ(blet::Thread::Attributes().completion_fd(), -1);
+    EXPECT_EQ(attributes_.completion_fd(), fd_);
+}
+
+TEST_F(CompletionFd, inlineCall) {
+    int flag = 0;
+    blet::Thread thrd(attributes_);
+    thrd.start(&block, &flag);
+    EXPECT_FALSE(isSignaled(fd_));
+    __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+    thrd.join();
+}
+
+TEST_F(CompletionFd, heapCall) {
+    blet::Thread thrd(attributes_);
+    thrd.start(&large, Large());
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+    thrd.join();
+}
+
+TEST_F(CompletionFd, argumentsDestroyed) {
+    int live = 0;
+    int flag = 0;
+    blet::Thread thrd(attributes_);
+    thrd.start(&slowDestroy, SlowDestroy(&live), &flag);
+    __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+    // signaled after the copies of the thread are destroyed
+    EXPECT_EQ(__atomic_load_n(&live, __ATOMIC_ACQUIRE), 0);
+    thrd.join();
+}
+
+TEST_F(CompletionFd, exception) {
+    blet::Thread thrd(attributes_);
+    thrd.start(&throwError);
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join(), std::runtime_error);
+#else
+    EXPECT_THROW(thrd.join(), blet::Thread::UncaughtException);
+#endif
+}
+
+TEST_F(CompletionFd, cancel) {
+    blet::Thread thrd(attributes_);
+    thrd.start(&blockForever);
+    thrd.cancel();
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+    thrd.join();
+}
+
+TEST_F(CompletionFd, persistent) {
+    int flag = 1;
+    blet::Thread thrd(attributes_);
+    thrd.set_persistent(true);
+    for (int i = 0; i < 3; ++i) {
+        thrd.start(&block, &flag);
+        EXPECT_EQ(waitCompletion(fd_), 1U);
+        thrd.join();
+    }
+}
+
+TEST_F(CompletionFd, threadGroup) {
+    int flag = 1;
+    blet::ThreadGroup group(attributes_);
+    for (int i = 0; i < 4; ++i) {
+        group.submit(&block, &flag);
+    }
+    EXPECT_FALSE(isSignaled(fd_));
+    group.release();
+    // once for the whole batch
+    EXPECT_EQ(waitCompletion(fd_), 1U);
+    group.join();
+    EXPECT_FALSE(isSignaled(fd_));
+}
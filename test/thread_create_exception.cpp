@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <stdexcept>
 #include <vector>
 
 #include "blet/mockc.h"
@@ -272,3 +273,99 @@ GTEST_TEST(thread, methodArg2Const) {
         },
         blet::Thread::Exception);
 }
+
+struct LargeArg {
+    int values[128];
+};
+
+static void staticMethodLargeArg(LargeArg arg) {
+    (void)arg;
+}
+
+GTEST_TEST(thread, staticMethodLargeArg) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            try {
+                LargeArg arg;
+                blet::Thread thrd;
+                thrd.start(&staticMethodLargeArg, arg);
+            }
+            catch (const blet::Thread::Exception& e) {
+                EXPECT_STREQ(e.what(), "Failed to create thread");
+                throw;
+            }
+        },
+        blet::Thread::Exception);
+}
+
+GTEST_TEST(thread, persistent) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            try {
+                blet::Thread thrd;
+                thrd.set_persistent(true);
+                thrd.start(&MyTest::staticMethodVoid);
+            }
+            catch (const blet::Thread::Exception& e) {
+                EXPECT_STREQ(e.what(), "Failed to create thread");
+                throw;
+            }
+        },
+        blet::Thread::Exception);
+}
+
+// copied without throwing only by the thread that built it
+struct ThrowInOtherThread {
+    ThrowInOtherThread() :
+        owner(::pthread_self()) {}
+    ThrowInOtherThread(const ThrowInOtherThread& rhs) :
+        owner(rhs.owner) {
+        if (!::pthread_equal(owner, ::pthread_self())) {
+            throw std::runtime_error("copy");
+        }
+    }
+    pthread_t owner;
+};
+
+static void throwInOtherThread(ThrowInOtherThread) {}
+
+GTEST_TEST(thread, copyException) {
+    blet::Thread thrd;
+    try {
+        thrd.start(&throwInOtherThread, ThrowInOtherThread());
+        FAIL();
+    }
+    catch (const std::exception& e) {
+        // the copy made by the new thread, an UncaughtException before C++11
+        EXPECT_STREQ(e.what(), "copy");
+    }
+    EXPECT_FALSE(thrd.joinable());
+    thrd.start(&MyTest::staticMethodVoid);
+    thrd.join();
+}
+
+GTEST_TEST(thread, copyExceptionDetached) {
+    blet::Thread::Attributes attributes;
+    attributes.set_detached(true);
+    blet::Thread thrd(attributes);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.start(&throwInOtherThread, ThrowInOtherThread()),
+                 std::runtime_error);
+#else
+    EXPECT_THROW(thrd.start(&throwInOtherThread, ThrowInOtherThread()),
+                 blet::Thread::UncaughtException);
+#endif
+    EXPECT_FALSE(thrd.joinable());
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "blet/thread.h"
+
+struct LargeArg {
+    int values[128];
+};
+
+static void staticMethodLargeArg(LargeArg arg, int* result) {
+    *result = arg.values[0];
+}
+
+static void allocateAndDeallocate(int count) {
+    std::vector<void*> blocks;
+    for (int i = 0; i < count; ++i) {
+        blocks.push_back(blet::ThreadDataPool::allocate(64 << (i % 7)));
+        *reinterpret_cast<int*>(blocks.back()) = i;
+        if (i % 3 == 0) {
+            for (std::size_t j = 0; j < blocks.size(); ++j) {
+                EXPECT_EQ(*reinterpret_cast<int*>(blocks[j]),
+                          static_cast<int>(i - blocks.size() + j + 1));
+            }
+            while (!blocks.empty()) {
+                blet::ThreadDataPool::deallocate(
+                    blocks.back(),
+                    64 << (*reinterpret_cast<int*>(blocks.back()) % 7));
+                blocks.pop_back();
+            }
+        }
+    }
+    while (!blocks.empty()) {
+        blet::ThreadDataPool::deallocate(
+            blocks.back(), 64 << (*reinterpret_cast<int*>(blocks.back()) % 7));
+        blocks.pop_back();
+    }
+}
+
+GTEST_TEST(threadDataPool, recycle) {
+    blet::ThreadDataPool::Stats before = blet::ThreadDataPool::stats();
+    void* pBlock = blet::ThreadDataPool::allocate(200);
+    blet::ThreadDataPool::deallocate(pBlock, 200);
+    void* pRecycled = blet::ThreadDataPool::allocate(256);
+#if BLET_THREAD_DATA_POOL
+    EXPECT_EQ(pBlock, pRecycled);
+#endif
+    blet::ThreadDataPool::deallocate(pRecycled, 256);
+    blet::ThreadDataPool::Stats after = blet::ThreadDataPool::stats();
+    EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + 2);
+#if BLET_THREAD_DATA_POOL
+    EXPECT_GE(after.hits, before.hits + 1);
+#else
+    // every block comes from the heap
+    EXPECT_EQ(after.hits, before.hits);
+#endif
+}
+
+GTEST_TEST(threadDataPool, oversized) {
+    blet::ThreadDataPool::Stats before = blet::ThreadDataPool::stats();
+    void* pBlock = blet::ThreadDataPool::allocate(8192);
+    blet::ThreadDataPool::deallocate(pBlock, 8192);
+    pBlock = blet::ThreadDataPool::allocate(8192);
+    blet::ThreadDataPool::deallocate(pBlock, 8192);
+    blet::ThreadDataPool::Stats after = blet::ThreadDataPool::stats();
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses + 2);
+}
+
+GTEST_TEST(threadDataPool, thread) {
+    LargeArg arg;
+    arg.values[0] = 42;
+    int result = 0;
+    blet::Thread thrd(&staticMethodLargeArg, arg, &result);
+    thrd.join();
+    EXPECT_EQ(result, 42);
+    blet::ThreadDataPool::Stats before = blet::ThreadDataPool::stats();
+    thrd.start(&staticMethodLargeArg, arg, &result);
+    thrd.join();
+    blet::ThreadDataPool::Stats after = blet::ThreadDataPool::stats();
+#if BLET_THREAD_DATA_POOL
+    EXPECT_EQ(after.hits, before.hits + 1);
+#else
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses + 1);
+#endif
+}
+
+GTEST_TEST(threadDataPool, concurrent) {
+    std::vector<blet::Thread*> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.push_back(new blet::Thread(&allocateAndDeallocate, 10000));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+GTEST_TEST(threadDataPool, localCache) {
+    blet::ThreadDataPool::LocalCache cache;
+    blet::ThreadDataPool::set_local_cache(&cache);
+    void* pBlock = blet::ThreadDataPool::allocate(64);
+    blet::ThreadDataPool::deallocate(pBlock, 64);
+    blet::ThreadDataPool::Stats before = blet::ThreadDataPool::stats();
+    void* pCached = blet::ThreadDataPool::allocate(64);
+    blet::ThreadDataPool::Stats during = blet::ThreadDataPool::stats();
+#if BLET_THREAD_DATA_POOL
+    // served by the cache, the shared free lists are not touched
+    EXPECT_EQ(pCached, pBlock);
+    EXPECT_EQ(during.hits, before.hits);
+    EXPECT_EQ(during.misses, before.misses);
+#else
+    EXPECT_EQ(during.misses, before.misses + 1);
+#endif
+    blet::ThreadDataPool::deallocate(pCached, 64);
+    // more blocks than the cache keeps
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(blet::ThreadDataPool::allocate(64));
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        blet::ThreadDataPool::deallocate(blocks[i], 64);
+    }
+    blet::ThreadDataPool::set_local_cache(NULL);
+    blet::ThreadDataPool::Stats after = blet::ThreadDataPool::stats();
+    // the hits of the cache are counted once it is flushed
+    EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + 101);
+#if BLET_THREAD_DATA_POOL
+    EXPECT_GE(after.hits, before.hits + 2);
+#endif
+}
+
+struct ThrowOnCopy {
+    ThrowOnCopy() {
+        data[0] = '\0';
+    }
+    ThrowOnCopy(const ThrowOnCopy&) {
+        throw std::runtime_error("copy");
+    }
+    ThrowOnCopy(const ThrowOnCopy&, int) {
+        throw std::runtime_error("construct");
+    }
+    char data[256];
+};
+
+GTEST_TEST(threadDataPool, createException) {
+    blet::ThreadDataPool::Stats before = blet::ThreadDataPool::stats();
+    ThrowOnCopy value;
+    EXPECT_THROW(blet::ThreadDataPool::create(value), std::runtime_error);
+    EXPECT_THROW(blet::ThreadDataPool::create<ThrowOnCopy>(value, 0),
+                 std::runtime_error);
+    // the block went back to the pool
+    void* pBlock = blet::ThreadDataPool::allocate(sizeof(ThrowOnCopy));
+    blet::ThreadDataPool::deallocate(pBlock, sizeof(ThrowOnCopy));
+    blet::ThreadDataPool::Stats after = blet::ThreadDataPool::stats();
+#if BLET_THREAD_DATA_POOL
+    EXPECT_GE(after.hits, before.hits + 1);
+#else
+    EXPECT_EQ(after.hits, before.hits);
+#endif
+}
+
+struct Increment {
+    void call() {
+        ++*pValue;
+    }
+    int* pValue;
+};
+
+GTEST_TEST(threadDataPool, task) {
+    int value = 0;
+    Increment increment;
+    increment.pValue = &value;
+    blet::Task empty;
+    EXPECT_TRUE(empty.empty());
+    blet::Task task = blet::Task::create(increment);
+    EXPECT_FALSE(task.empty());
+    EXPECT_TRUE(task.run() == NULL);
+    EXPECT_EQ(value, 1);
+    // released without being called
+    task = blet::Task::create(increment);
+    task.destroy();
+    EXPECT_EQ(value, 1);
+}
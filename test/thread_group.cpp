@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "blet/mockc.h"
+#include "blet/thread_group.h"
+
+using ::testing::_;
+using ::testing::Return;
+
+static void increment(int* pCount) {
+    __atomic_fetch_add(pCount, 1, __ATOMIC_RELAXED);
+}
+
+static void incrementBy(int* pCount, int value) {
+    __atomic_fetch_add(pCount, value, __ATOMIC_RELAXED);
+}
+
+static void throwError(const char* message) {
+    throw std::runtime_error(message);
+}
+
+static void readStackSize(std::size_t* pStackSize) {
+    pthread_attr_t attr;
+    ::pthread_getattr_np(::pthread_self(), &attr);
+    ::pthread_attr_getstacksize(&attr, pStackSize);
+    ::pthread_attr_destroy(&attr);
+}
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+
+GTEST_TEST(threadGroup, join) {
+    int count = 0;
+    blet::ThreadGroup group;
+    EXPECT_EQ(group.size(), 0U);
+    for (int i = 0; i < 16; ++i) {
+        group.submit(&incrementBy, &count, i);
+    }
+    EXPECT_EQ(group.size(), 16U);
+    group.join();
+    EXPECT_EQ(count, 120);
+    EXPECT_EQ(group.size(), 0U);
+}
+
+GTEST_TEST(threadGroup, startBarrier) {
+    int count = 0;
+    blet::ThreadGroup group;
+    for (int i = 0; i < 8; ++i) {
+        group.submit(&increment, &count);
+    }
+    // nothing runs before release
+    ::usleep(20000);
+    EXPECT_EQ(__atomic_load_n(&count, __ATOMIC_RELAXED), 0);
+    group.release();
+    while (__atomic_load_n(&count, __ATOMIC_RELAXED) != 8) {
+        ::sched_yield();
+    }
+    // submitted after release
+    group.submit(&increment, &count);
+    group.join();
+    EXPECT_EQ(count, 9);
+}
+
+GTEST_TEST(threadGroup, batches) {
+    int count = 0;
+    blet::ThreadGroup group;
+    for (int batch = 0; batch < 4; ++batch) {
+        for (int i = 0; i < 4; ++i) {
+            group.submit(&increment, &count);
+        }
+        group.join();
+        EXPECT_EQ(count, (batch + 1) * 4);
+    }
+    // empty batch
+    group.join();
+    group.submit(&increment, &count);
+    ::usleep(20000);
+    EXPECT_EQ(__atomic_load_n(&count, __ATOMIC_RELAXED), 16);
+    group.join();
+    EXPECT_EQ(count, 17);
+}
+
+GTEST_TEST(threadGroup, exception) {
+    int count = 0;
+    blet::ThreadGroup group;
+    group.submit(&throwError, "first");
+    group.submit(&throwError, "second");
+    group.submit(&increment, &count);
+    EXPECT_THROW(group.join(), std::exception);
+    EXPECT_EQ(count, 1);
+    // rethrown once
+    group.join();
+
+    // dropped by the destructor
+    blet::ThreadGroup dropped;
+    dropped.submit(&throwError, "dropped");
+}
+
+GTEST_TEST(threadGroup, destructor) {
+    int count = 0;
+    {
+        blet::ThreadGroup group;
+        for (int i = 0; i < 4; ++i) {
+            group.submit(&increment, &count);
+        }
+    }
+    EXPECT_EQ(count, 4);
+}
+
+GTEST_TEST(threadGroup, attributes) {
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_size(256 * 1024);
+    attributes.set_stack_cache(true);
+    // ignored
+    attributes.set_detached(true);
+
+    std::size_t stackSizes[2] = {0, 0};
+    blet::ThreadGroup group(attributes);
+    group.submit(&readStackSize, &stackSizes[0]);
+    group.submit(&readStackSize, &stackSizes[1]);
+    group.join();
+    EXPECT_EQ(stackSizes[0], 256U * 1024U);
+    EXPECT_EQ(stackSizes[1], 256U * 1024U);
+}
+
+GTEST_TEST(threadGroup, createException) {
+    int count = 0;
+    blet::ThreadGroup group;
+    group.submit(&increment, &count);
+
+    MOCKC_NEW_INSTANCE(pthread_create);
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Return(-1));
+    {
+        MOCKC_GUARD(pthread_create);
+        try {
+            group.submit(&increment, &count);
+            FAIL();
+        }
+        catch (const blet::Thread::Exception& e) {
+            EXPECT_STREQ(e.what(), "Failed to create thread");
+        }
+    }
+    EXPECT_EQ(group.size(), 1U);
+    group.join();
+    EXPECT_EQ(count, 1);
+}
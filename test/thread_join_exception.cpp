@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "blet/thread.h"
+
+struct MyTest {
+    static void staticMethodThrow(const char* a1) {
+        throw std::runtime_error(a1);
+    }
+    static void staticMethodThrowInt() {
+        throw 42;
+    }
+    static void staticMethodThrowLarge(std::string a1, std::string a2,
+                                       std::string a3, std::string a4,
+                                       std::string a5, std::string a6) {
+        if (!a1.empty()) {
+            throw std::runtime_error(a1 + a2 + a3 + a4 + a5 + a6);
+        }
+    }
+    static void staticMethodWaitCancel() {
+        for (;;) {
+            ::pthread_testcancel();
+            ::usleep(1000);
+        }
+    }
+    static void staticMethodVoid() {}
+    static void staticMethodThrowDetached(int* a1, int* a2) {
+        while (__atomic_load_n(a1, __ATOMIC_ACQUIRE) == 0) {
+            ::usleep(1000);
+        }
+        __atomic_store_n(a2, 1, __ATOMIC_RELEASE);
+        throw std::runtime_error("detached");
+    }
+
+    void methodThrow() {
+        throw std::logic_error("method");
+    }
+};
+
+GTEST_TEST(threadJoinException, inlineCall) {
+    blet::Thread thrd(&MyTest::staticMethodThrow, "boom");
+    EXPECT_THROW(
+        {
+            try {
+                thrd.join();
+            }
+            catch (const std::exception& e) {
+                EXPECT_STREQ(e.what(), "boom");
+                throw;
+            }
+        },
+        std::exception);
+    EXPECT_FALSE(thrd.joinable());
+    // the thread can be started again
+    thrd.start(&MyTest::staticMethodVoid);
+    EXPECT_NO_THROW(thrd.join());
+}
+
+GTEST_TEST(threadJoinException, heapCall) {
+    std::string a("a");
+    blet::Thread thrd(&MyTest::staticMethodThrowLarge, a, a, a, a, a, a);
+    EXPECT_THROW(
+        {
+            try {
+                thrd.join();
+            }
+            catch (const std::exception& e) {
+                EXPECT_STREQ(e.what(), "aaaaaa");
+                throw;
+            }
+        },
+        std::exception);
+    thrd.start(&MyTest::staticMethodThrowLarge, std::string(), a, a, a, a, a);
+    EXPECT_NO_THROW(thrd.join());
+}
+
+GTEST_TEST(threadJoinException, method) {
+    MyTest t;
+    blet::Thread thrd(&MyTest::methodThrow, &t);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join(), std::logic_error);
+#else
+    EXPECT_THROW(thrd.join(), blet::Thread::UncaughtException);
+#endif
+}
+
+GTEST_TEST(threadJoinException, unknown) {
+    blet::Thread thrd(&MyTest::staticMethodThrowInt);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join(), int);
+#else
+    EXPECT_THROW(
+        {
+            try {
+                thrd.join();
+            }
+            catch (const blet::Thread::UncaughtException& e) {
+                EXPECT_STREQ(e.what(), "Unknown exception");
+                throw;
+            }
+        },
+        blet::Thread::UncaughtException);
+#endif
+}
+
+GTEST_TEST(threadJoinException, uncaughtException) {
+    std::string message(300, 'x');
+    blet::Thread::UncaughtException e(0, message.c_str());
+    blet::Thread::UncaughtException copy(e);
+    // the copy owns its message
+    EXPECT_NE(copy.what(), e.what());
+    EXPECT_EQ(std::string(copy.what()), std::string(255, 'x'));
+}
+
+GTEST_TEST(threadJoinException, cancel) {
+    blet::Thread thrd(&MyTest::staticMethodWaitCancel);
+    thrd.cancel();
+    // the cancellation unwinds through the thread function, nothing to
+    // rethrow
+    EXPECT_NO_THROW(thrd.join());
+}
+
+GTEST_TEST(threadJoinException, destructorDrops) {
+    blet::Thread thrd(&MyTest::staticMethodThrow, "dropped");
+}
+
+GTEST_TEST(threadJoinException, detached) {
+    int isDetached = 0;
+    int isDone = 0;
+    blet::Thread thrd(&MyTest::staticMethodThrowDetached, &isDetached,
+                      &isDone);
+    thrd.detach();
+    __atomic_store_n(&isDetached, 1, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&isDone, __ATOMIC_ACQUIRE) == 0) {
+        ::usleep(1000);
+    }
+    // let the thread drop its exception
+    ::usleep(50000);
+}
+
+GTEST_TEST(threadJoinException, persistent) {
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    thrd.start(&MyTest::staticMethodThrow, "job");
+    EXPECT_THROW(thrd.join(), std::exception);
+    thrd.start(&MyTest::staticMethodVoid);
+    EXPECT_NO_THROW(thrd.join());
+    // never joined, dropped with the worker
+    thrd.start(&MyTest::staticMethodThrow, "dropped");
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "blet/thread.h"
+
+struct LargeArg {
+    int values[128];
+};
+
+static void staticMethodIncrement(int* value) {
+    ++*value;
+}
+
+static void staticMethodSleep(int* value) {
+    usleep(100000);
+    *value = 42;
+}
+
+static void staticMethodLargeArg(LargeArg arg, int* result) {
+    *result = arg.values[0];
+}
+
+static void staticMethodNativeHandle(pthread_t* result) {
+    *result = pthread_self();
+}
+
+GTEST_TEST(threadPersistent, restart) {
+    int value = 0;
+    pthread_t handle = 0;
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    EXPECT_TRUE(thrd.persistent());
+    EXPECT_FALSE(thrd.joinable());
+    thrd.start(&staticMethodNativeHandle, &handle);
+    thrd.join();
+    const pthread_t worker = thrd.native_handle();
+    EXPECT_TRUE(pthread_equal(handle, worker));
+    for (int i = 0; i < 1000; ++i) {
+        thrd.start(&staticMethodIncrement, &value);
+        EXPECT_TRUE(thrd.joinable());
+        thrd.join();
+        EXPECT_FALSE(thrd.joinable());
+        EXPECT_EQ(value, i + 1);
+    }
+    thrd.start(&staticMethodNativeHandle, &handle);
+    thrd.join();
+    EXPECT_TRUE(pthread_equal(handle, worker));
+}
+
+GTEST_TEST(threadPersistent, largeArg) {
+    LargeArg arg;
+    arg.values[0] = 42;
+    int result = 0;
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    thrd.start(&staticMethodLargeArg, arg, &result);
+    thrd.join();
+    EXPECT_EQ(result, 42);
+}
+
+GTEST_TEST(threadPersistent, alreadyStarted) {
+    int value = 0;
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    thrd.start(&staticMethodSleep, &value);
+    EXPECT_THROW(thrd.start(&staticMethodSleep, &value),
+                 blet::Thread::Exception);
+    EXPECT_THROW(thrd.set_persistent(false), blet::Thread::Exception);
+    EXPECT_THROW(thrd.cancel(), blet::Thread::Exception);
+    EXPECT_THROW(thrd.detach(), blet::Thread::Exception);
+    thrd.join();
+    EXPECT_EQ(value, 42);
+    EXPECT_THROW(thrd.join(), blet::Thread::Exception);
+}
+
+GTEST_TEST(threadPersistent, notJoining) {
+    int value = 0;
+    {
+        blet::Thread thrd;
+        thrd.set_persistent(true);
+        thrd.start(&staticMethodSleep, &value);
+    }
+    EXPECT_EQ(value, 42);
+}
+
+GTEST_TEST(threadPersistent, disable) {
+    int value = 0;
+    blet::Thread thrd;
+    EXPECT_FALSE(thrd.persistent());
+    thrd.set_persistent(true);
+    thrd.start(&staticMethodIncrement, &value);
+    thrd.join();
+    thrd.set_persistent(false);
+    EXPECT_FALSE(thrd.persistent());
+    EXPECT_EQ(thrd.native_handle(), static_cast<pthread_t>(0));
+    thrd.start(&staticMethodIncrement, &value);
+    EXPECT_THROW(thrd.set_persistent(true), blet::Thread::Exception);
+    thrd.join();
+    EXPECT_EQ(value, 2);
+}
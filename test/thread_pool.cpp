@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "blet/mockc.h"
+#include "blet/thread_pool.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+struct MyTest {
+    MyTest() :
+        count(0) {}
+
+    static void staticMethodVoid() {
+        __atomic_fetch_add(&staticCount, 1, __ATOMIC_RELAXED);
+    }
+    static void staticMethodArg1(int& a1) {
+        __atomic_fetch_add(&a1, 1, __ATOMIC_RELAXED);
+    }
+    static void staticMethodArg10(int* a1, int a2, int a3, int a4, int a5,
+                                  int a6, int a7, int a8, int a9, int a10) {
+        __atomic_fetch_add(a1, a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10,
+                           __ATOMIC_RELAXED);
+    }
+
+    void methodVoid() {
+        __atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
+    }
+    void methodArg2(int a1, int a2) {
+        __atomic_fetch_add(&count, a1 + a2, __ATOMIC_RELAXED);
+    }
+    void methodArg1Const(int* a1) const {
+        __atomic_fetch_add(a1, 1, __ATOMIC_RELAXED);
+    }
+
+    static int staticCount;
+    int count;
+};
+
+int MyTest::staticCount = 0;
+
+// fail the large allocations of this thread only, the queue chunks but not
+// the task blocks
+static __thread bool failLargeNew = false;
+
+#if __cplusplus >= 201103L
+void* operator new(std::size_t size) {
+#else
+void* operator new(std::size_t size) throw(std::bad_alloc) {
+#endif
+    if (failLargeNew && size >= 512) {
+        throw std::bad_alloc();
+    }
+    void* pBlock = std::malloc(size == 0 ? 1 : size);
+    if (pBlock == NULL) {
+        throw std::bad_alloc();
+    }
+    return pBlock;
+}
+
+// out of line, gcc warns on free of a new pointer once inlined
+#if __cplusplus >= 201103L
+__attribute__((noinline)) void operator delete(void* pBlock) noexcept {
+#else
+__attribute__((noinline)) void operator delete(void* pBlock) throw() {
+#endif
+    std::free(pBlock);
+}
+
+#ifdef __cpp_sized_deallocation
+__attribute__((noinline)) void operator delete(void* pBlock,
+                                               std::size_t) noexcept {
+    std::free(pBlock);
+}
+#endif
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+
+GTEST_TEST(threadPool, size) {
+    blet::ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3u);
+    blet::ThreadPool defaultPool;
+    EXPECT_GE(defaultPool.size(), 1u);
+}
+
+GTEST_TEST(threadPool, submit) {
+    MyTest t;
+    int value = 0;
+    int sum = 0;
+    int constCount = 0;
+    MyTest::staticCount = 0;
+    blet::ThreadPool pool(4);
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit(&MyTest::staticMethodVoid);
+        pool.submit<int&>(&MyTest::staticMethodArg1, value);
+        pool.submit(&MyTest::staticMethodArg10, &sum, 1, 1, 1, 1, 1, 1, 1, 1,
+                    1);
+        pool.submit(&MyTest::methodVoid, &t);
+        pool.submit(&MyTest::methodArg2, &t, 1, 2);
+        pool.submit(&MyTest::methodArg1Const, &t, &constCount);
+    }
+    pool.wait();
+    EXPECT_EQ(MyTest::staticCount, 1000);
+    EXPECT_EQ(value, 1000);
+    EXPECT_EQ(sum, 9000);
+    EXPECT_EQ(t.count, 4000);
+    EXPECT_EQ(constCount, 1000);
+}
+
+static void forkTree(blet::ThreadPool* pPool, int* pLeaves, int depth) {
+    if (depth == 0) {
+        __atomic_fetch_add(pLeaves, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    pPool->submit(&forkTree, pPool, pLeaves, depth - 1);
+    pPool->submit(&forkTree, pPool, pLeaves, depth - 1);
+}
+
+GTEST_TEST(threadPool, submitFromWorker) {
+    blet::ThreadPool pool(4);
+    for (int i = 0; i < 10; ++i) {
+        int leaves = 0;
+        pool.submit(&forkTree, &pool, &leaves, 8);
+        // also waits for the calls queued by the workers
+        pool.wait();
+        EXPECT_EQ(__atomic_load_n(&leaves, __ATOMIC_RELAXED), 1 << 8);
+    }
+}
+
+GTEST_TEST(threadPool, destructorRunsPending) {
+    MyTest::staticCount = 0;
+    {
+        blet::ThreadPool pool(1);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit(&MyTest::staticMethodVoid);
+        }
+    }
+    EXPECT_EQ(MyTest::staticCount, 1000);
+}
+
+GTEST_TEST(threadPool, createException) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Invoke(mockc_real_func_pthread_create_singleton()))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            try {
+                blet::ThreadPool pool(2);
+            }
+            catch (const blet::Thread::Exception& e) {
+                EXPECT_STREQ(e.what(), "Failed to create thread");
+                throw;
+            }
+        },
+        blet::Thread::Exception);
+}
+
+static void throwRuntimeError(const char* a1) {
+    throw std::runtime_error(a1);
+}
+
+GTEST_TEST(threadPool, waitRethrows) {
+    MyTest::staticCount = 0;
+    blet::ThreadPool pool(2);
+    pool.submit(&throwRuntimeError, "boom");
+    pool.submit(&throwRuntimeError, "boom");
+    for (int i = 0; i < 100; ++i) {
+        pool.submit(&MyTest::staticMethodVoid);
+    }
+    EXPECT_THROW(
+        {
+            try {
+                pool.wait();
+            }
+            catch (const std::exception& e) {
+                EXPECT_STREQ(e.what(), "boom");
+                throw;
+            }
+        },
+        std::exception);
+    EXPECT_EQ(MyTest::staticCount, 100);
+    // the workers survive, the exception is only reported once
+    pool.submit(&MyTest::staticMethodVoid);
+    EXPECT_NO_THROW(pool.wait());
+    EXPECT_EQ(MyTest::staticCount, 101);
+    // never waited, dropped with the pool
+    pool.submit(&throwRuntimeError, "dropped");
+}
+
+static void submitUntilBadAlloc(blet::ThreadPool* pPool, int* pSubmitted) {
+    failLargeNew = true;
+    try {
+        // the queue needs a new chunk before the end
+        for (int i = 0; i < 10000; ++i) {
+            pPool->submit(&MyTest::staticMethodVoid);
+            ++*pSubmitted;
+        }
+    }
+    catch (const std::bad_alloc&) {
+    }
+    failLargeNew = false;
+}
+
+GTEST_TEST(threadPool, submitBadAlloc) {
+    MyTest::staticCount = 0;
+    blet::ThreadPool pool(1);
+    int fromCaller = 0;
+    int fromWorker = 0;
+    submitUntilBadAlloc(&pool, &fromCaller);
+    pool.submit(&submitUntilBadAlloc, &pool, &fromWorker);
+    // the failed calls are not pending
+    pool.wait();
+    EXPECT_LT(fromCaller, 10000);
+    EXPECT_LT(fromWorker, 10000);
+    EXPECT_EQ(MyTest::staticCount, fromCaller + fromWorker);
+}
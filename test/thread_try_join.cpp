@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <sched.h>
+#include <time.h>
+
+#include <stdexcept>
+
+#include "blet/mockc.h"
+#include "blet/thread.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+
+static void block(int* pFlag) {
+    while (__atomic_load_n(pFlag, __ATOMIC_ACQUIRE) == 0) {
+        ::sched_yield();
+    }
+}
+
+static void blockThrow(int* pFlag) {
+    block(pFlag);
+    throw std::runtime_error("blockThrow");
+}
+
+static void release(int* pFlag) {
+    __atomic_store_n(pFlag, 1, __ATOMIC_RELEASE);
+}
+
+static void waitFinished(blet::Thread* pThread) {
+    while (!pThread->is_finished()) {
+        ::sched_yield();
+    }
+}
+
+static void blockForever() {
+    for (;;) {
+        ::pthread_testcancel();
+        ::sched_yield();
+    }
+}
+
+GTEST_TEST(thread, tryJoin) {
+    int flag = 0;
+    blet::Thread thrd(&block, &flag);
+    EXPECT_FALSE(thrd.try_join());
+    EXPECT_FALSE(thrd.is_finished());
+    EXPECT_TRUE(thrd.joinable());
+    release(&flag);
+    waitFinished(&thrd);
+    // still joinable until joined
+    EXPECT_TRUE(thrd.joinable());
+    EXPECT_TRUE(thrd.is_finished());
+    EXPECT_TRUE(thrd.try_join());
+    EXPECT_FALSE(thrd.joinable());
+    EXPECT_FALSE(thrd.is_finished());
+    EXPECT_THROW(thrd.try_join(), blet::Thread::Exception);
+}
+
+GTEST_TEST(thread, joinFor) {
+    int flag = 0;
+    blet::Thread thrd(&block, &flag);
+    EXPECT_FALSE(thrd.join_for(10));
+    EXPECT_TRUE(thrd.joinable());
+    release(&flag);
+    EXPECT_TRUE(thrd.join_for(10000));
+    EXPECT_FALSE(thrd.joinable());
+    EXPECT_THROW(thrd.join_for(10), blet::Thread::Exception);
+}
+
+MOCKC_ATTRIBUTE_METHOD2(int, clock_gettime,
+                        (clockid_t __clock_id, struct timespec* __tp), throw());
+
+// the wall clock jumps an hour ahead
+static int clockAhead(clockid_t clockId, struct timespec* pTime) {
+    int result = mockc_real_func_clock_gettime_singleton()(clockId, pTime);
+    if (clockId == CLOCK_REALTIME) {
+        pTime->tv_sec += 3600;
+    }
+    return result;
+}
+
+GTEST_TEST(thread, joinForWallClock) {
+    int flag = 0;
+    blet::Thread thrd(&block, &flag);
+    MOCKC_NEW_INSTANCE(clock_gettime);
+    EXPECT_CALL(MOCKC_INSTANCE(clock_gettime), clock_gettime(_, _))
+        .WillRepeatedly(Invoke(&clockAhead));
+    {
+        MOCKC_GUARD(clock_gettime);
+        // the timeout does not move with the wall clock
+        EXPECT_FALSE(thrd.join_for(10));
+    }
+    release(&flag);
+    EXPECT_TRUE(thrd.join_for(10000));
+}
+
+GTEST_TEST(thread, joinForException) {
+    int flag = 1;
+    blet::Thread thrd(&blockThrow, &flag);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join_for(10000), std::runtime_error);
+#else
+    EXPECT_THROW(thrd.join_for(10000), blet::Thread::UncaughtException);
+#endif
+    EXPECT_FALSE(thrd.joinable());
+}
+
+GTEST_TEST(thread, isFinishedJoin) {
+    int flag = 1;
+    blet::Thread thrd(&blockThrow, &flag);
+    waitFinished(&thrd);
+    // the exception waits for join
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.join(), std::runtime_error);
+#else
+    EXPECT_THROW(thrd.join(), blet::Thread::UncaughtException);
+#endif
+    EXPECT_FALSE(thrd.joinable());
+
+    // restart once reaped and joined
+    thrd.start(&block, &flag);
+    waitFinished(&thrd);
+    thrd.join();
+}
+
+GTEST_TEST(thread, isFinishedCancel) {
+    blet::Thread thrd(&blockForever);
+    thrd.cancel();
+    waitFinished(&thrd);
+    // nothing left to cancel
+    thrd.cancel();
+    thrd.join();
+}
+
+GTEST_TEST(thread, isFinishedDetach) {
+    int flag = 1;
+    blet::Thread thrd(&blockThrow, &flag);
+    waitFinished(&thrd);
+    thrd.detach();
+    EXPECT_FALSE(thrd.joinable());
+    EXPECT_FALSE(thrd.is_finished());
+}
+
+GTEST_TEST(thread, isFinishedDestroy) {
+    int flag = 1;
+    blet::Thread::Attributes attributes;
+    attributes.set_stack_cache(true);
+    blet::Thread thrd(attributes);
+    thrd.start(&blockThrow, &flag);
+    // reaped, dropped by the destructor
+    waitFinished(&thrd);
+}
+
+GTEST_TEST(thread, persistentTryJoin) {
+    int flag = 0;
+    blet::Thread thrd;
+    thrd.set_persistent(true);
+    EXPECT_FALSE(thrd.is_finished());
+    thrd.start(&block, &flag);
+    EXPECT_FALSE(thrd.try_join());
+    EXPECT_FALSE(thrd.join_for(10));
+    EXPECT_FALSE(thrd.is_finished());
+    release(&flag);
+    EXPECT_TRUE(thrd.join_for(10000));
+    EXPECT_FALSE(thrd.joinable());
+
+    thrd.start(&blockThrow, &flag);
+    waitFinished(&thrd);
+#if __cplusplus >= 201103L
+    EXPECT_THROW(thrd.try_join(), std::runtime_error);
+#else
+    EXPECT_THROW(thrd.try_join(), blet::Thread::UncaughtException);
+#endif
+    EXPECT_FALSE(thrd.joinable());
+}
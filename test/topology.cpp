@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <ftw.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+
+#include "blet/thread.h"
+#include "blet/topology.h"
+
+static void writeFile(const std::string& path, const char* value) {
+    std::FILE* pFile = std::fopen(path.c_str(), "w");
+    ASSERT_TRUE(pFile != NULL);
+    std::fputs(value, pFile);
+    std::fclose(pFile);
+}
+
+static int removeEntry(const char* path, const struct stat*, int,
+                       struct FTW*) {
+    return ::remove(path);
+}
+
+static std::string toString(int value) {
+    char buffer[16];
+    std::sprintf(buffer, "%d", value);
+    return buffer;
+}
+
+// 2 packages, 2 cores per package, 2 SMT threads per core:
+// cpu 0 and 4 on the core 0 of the package 0, cpu 1 and 5 on its core 1
+// cpu 2 and 6 on the core 0 of the package 1, cpu 3 and 7 on its core 1
+// L1 and L2 per core, L3 per package, cpu 7 offline
+class FakeSysfs : public ::testing::Test {
+  protected:
+    void SetUp() {
+        char dir[] = "/tmp/blet_topology_XXXXXX";
+        ASSERT_TRUE(::mkdtemp(dir) != NULL);
+        root_ = dir;
+        writeFile(root_ + "/online", "0-6\n");
+        writeFile(root_ + "/isolated", "3,6\n");
+        for (int id = 0; id < 7; ++id) {
+            int package = id % 4 / 2;
+            int core = id % 2;
+            std::string cpu = root_ + "/cpu" + toString(id);
+            std::string siblings =
+                toString(id % 4) + "," + toString(id % 4 + 4);
+            std::string packageCpus =
+                toString(package * 2) + "-" + toString(package * 2 + 1) + "," +
+                toString(package * 2 + 4) + "-" + toString(package * 2 + 5);
+            ::mkdir(cpu.c_str(), 0700);
+            ::mkdir((cpu + "/topology").c_str(), 0700);
+            writeFile(cpu + "/topology/physical_package_id",
+                      (toString(package) + "\n").c_str());
+            writeFile(cpu + "/topology/core_id",
+                      (toString(core) + "\n").c_str());
+            writeFile(cpu + "/topology/thread_siblings_list",
+                      (siblings + "\n").c_str());
+            ::mkdir((cpu + "/cache").c_str(), 0700);
+            writeCache(cpu + "/cache/index0", "1", "Data", "48K", siblings);
+            writeCache(cpu + "/cache/index1", "1", "Instruction", "32K",
+                       siblings);
+            writeCache(cpu + "/cache/index2", "2", "Unified", "2048K",
+                       siblings);
+            writeCache(cpu + "/cache/index3", "3", "Unified", "32M",
+                       packageCpus);
+        }
+    }
+
+    void TearDown() {
+        ::nftw(root_.c_str(), &removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    static void writeCache(const std::string& path, const char* level,
+                           const char* type, const char* size,
+                           const std::string& cpus) {
+        ::mkdir(path.c_str(), 0700);
+        writeFile(path + "/level", level);
+        writeFile(path + "/type", type);
+        writeFile(path + "/size", size);
+        writeFile(path + "/shared_cpu_list", cpus.c_str());
+    }
+
+    std::string root_;
+};
+
+GTEST_TEST(topology, parseCpuList) {
+    cpu_set_t cpus;
+    EXPECT_TRUE(blet::Topology::parse_cpu_list("0-3,8,10-11\n", &cpus));
+    EXPECT_EQ(CPU_COUNT(&cpus), 7);
+    EXPECT_TRUE(CPU_ISSET(3, &cpus));
+    EXPECT_FALSE(CPU_ISSET(4, &cpus));
+    EXPECT_TRUE(CPU_ISSET(11, &cpus));
+
+    EXPECT_TRUE(blet::Topology::parse_cpu_list("", &cpus));
+    EXPECT_EQ(CPU_COUNT(&cpus), 0);
+    EXPECT_TRUE(blet::Topology::parse_cpu_list("\n", &cpus));
+    EXPECT_EQ(CPU_COUNT(&cpus), 0);
+
+    EXPECT_FALSE(blet::Topology::parse_cpu_list("a", &cpus));
+    EXPECT_FALSE(blet::Topology::parse_cpu_list("3-1", &cpus));
+    EXPECT_FALSE(blet::Topology::parse_cpu_list("1-", &cpus));
+    EXPECT_FALSE(blet::Topology::parse_cpu_list("1;2", &cpus));
+}
+
+TEST_F(FakeSysfs, cpus) {
+    blet::Topology topology(root_.c_str());
+    ASSERT_EQ(topology.cpus().size(), 7U);
+    EXPECT_EQ(CPU_COUNT(&topology.online()), 7);
+    EXPECT_EQ(CPU_COUNT(&topology.isolated()), 2);
+    EXPECT_TRUE(CPU_ISSET(6, &topology.isolated()));
+    EXPECT_EQ(topology.package_count(), 2U);
+    EXPECT_EQ(topology.core_count(), 4U);
+    EXPECT_TRUE(topology.cpu(7) == NULL);
+
+    const blet::Topology::Cpu* pCpu = topology.cpu(6);
+    ASSERT_TRUE(pCpu != NULL);
+    EXPECT_EQ(pCpu->id, 6);
+    EXPECT_EQ(pCpu->package, 1);
+    EXPECT_EQ(pCpu->core, 0);
+    EXPECT_EQ(CPU_COUNT(&pCpu->siblings), 2);
+    EXPECT_TRUE(CPU_ISSET(2, &pCpu->siblings));
+    ASSERT_EQ(pCpu->caches.size(), 4U);
+    EXPECT_EQ(pCpu->caches[0].type, blet::Topology::CACHE_DATA);
+    EXPECT_EQ(pCpu->caches[0].size, 48U * 1024U);
+    EXPECT_EQ(pCpu->caches[1].type, blet::Topology::CACHE_INSTRUCTION);
+    EXPECT_EQ(pCpu->caches[2].level, 2);
+    EXPECT_EQ(pCpu->caches[2].type, blet::Topology::CACHE_UNIFIED);
+    EXPECT_EQ(pCpu->caches[3].size, 32U * 1024U * 1024U);
+
+    cpu_set_t package = topology.package_cpus(0);
+    EXPECT_EQ(CPU_COUNT(&package), 4);
+    EXPECT_TRUE(CPU_ISSET(5, &package));
+}
+
+TEST_F(FakeSysfs, sharingCpu) {
+    blet::Topology topology(root_.c_str());
+
+    cpu_set_t l2 = topology.cache_cpus(1, 2);
+    EXPECT_EQ(CPU_COUNT(&l2), 2);
+    EXPECT_TRUE(CPU_ISSET(5, &l2));
+    cpu_set_t l3 = topology.cache_cpus(1, 3);
+    EXPECT_EQ(CPU_COUNT(&l3), 4);
+    cpu_set_t unknown = topology.cache_cpus(1, 4);
+    EXPECT_EQ(CPU_COUNT(&unknown), 0);
+
+    // L2 only shared with the SMT sibling
+    EXPECT_EQ(topology.sharing_cpu(1, 2), 5);
+    // L3 shared with the other core of the package
+    EXPECT_EQ(topology.sharing_cpu(1, 3), 0);
+    EXPECT_EQ(topology.sharing_cpu(2, 3), 3);
+    EXPECT_EQ(topology.sharing_cpu(3, 2), -1);
+    EXPECT_EQ(topology.sharing_cpu(7, 2), -1);
+    EXPECT_EQ(topology.sharing_cpu(1, 4), -1);
+}
+
+TEST_F(FakeSysfs, missingFiles) {
+    ::remove((root_ + "/isolated").c_str());
+    ::remove((root_ + "/cpu0/topology/core_id").c_str());
+    ::remove((root_ + "/cpu0/topology/thread_siblings_list").c_str());
+    ::remove((root_ + "/cpu0/cache/index0/type").c_str());
+    ::remove((root_ + "/cpu0/cache/index0/size").c_str());
+    ::remove((root_ + "/cpu0/cache/index0/shared_cpu_list").c_str());
+    writeFile(root_ + "/cpu0/topology/physical_package_id", "x\n");
+
+    blet::Topology topology(root_.c_str());
+    ASSERT_EQ(topology.cpus().size(), 7U);
+    EXPECT_EQ(CPU_COUNT(&topology.isolated()), 0);
+    const blet::Topology::Cpu* pCpu = topology.cpu(0);
+    ASSERT_TRUE(pCpu != NULL);
+    EXPECT_EQ(pCpu->package, -1);
+    EXPECT_EQ(pCpu->core, -1);
+    EXPECT_EQ(CPU_COUNT(&pCpu->siblings), 1);
+    EXPECT_EQ(pCpu->caches[0].type, blet::Topology::CACHE_UNIFIED);
+    EXPECT_EQ(pCpu->caches[0].size, 0U);
+    EXPECT_EQ(CPU_COUNT(&pCpu->caches[0].cpus), 1);
+}
+
+GTEST_TEST(topology, missingRoot) {
+    blet::Topology topology("/nonexistent/blet/topology");
+    EXPECT_TRUE(topology.cpus().empty());
+    EXPECT_EQ(CPU_COUNT(&topology.online()), 0);
+    EXPECT_EQ(topology.package_count(), 0U);
+    EXPECT_EQ(topology.core_count(), 0U);
+}
+
+static void readCpu(int* pCpu) {
+    *pCpu = ::sched_getcpu();
+}
+
+GTEST_TEST(topology, pinThread) {
+    blet::Topology topology;
+    if (topology.cpus().empty()) {
+        // no sysfs
+        return;
+    }
+    int last = topology.cpus().back().id;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(last, &cpus);
+    blet::Thread::Attributes attributes;
+    attributes.set_affinity(cpus);
+
+    int cpu = -1;
+    blet::Thread thrd(attributes);
+    thrd.start(&readCpu, &cpu);
+    thrd.join();
+    EXPECT_EQ(cpu, last);
+}
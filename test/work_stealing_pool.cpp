@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "blet/mockc.h"
+#include "blet/work_stealing_pool.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+struct MyTest {
+    MyTest() :
+        count(0) {}
+
+    static void staticMethodVoid() {
+        __atomic_fetch_add(&staticCount, 1, __ATOMIC_RELAXED);
+    }
+    static void staticMethodArg1(int& a1) {
+        __atomic_fetch_add(&a1, 1, __ATOMIC_RELAXED);
+    }
+
+    void methodArg2(int a1, int a2) {
+        __atomic_fetch_add(&count, a1 + a2, __ATOMIC_RELAXED);
+    }
+
+    static int staticCount;
+    int count;
+};
+
+int MyTest::staticCount = 0;
+
+// submit two children from the worker until depth is 0
+static void forkTree(blet::WorkStealingPool* pPool, int* pLeaves, int depth) {
+    if (depth == 0) {
+        __atomic_fetch_add(pLeaves, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    pPool->submit(&forkTree, pPool, pLeaves, depth - 1);
+    pPool->submit(&forkTree, pPool, pLeaves, depth - 1);
+}
+
+// create new function and singleton instance for mock
+MOCKC_METHOD4(int, pthread_create,
+              (pthread_t* __newthread, const pthread_attr_t* __attr,
+                  void* (*__start_routine)(void*), void* __arg));
+
+GTEST_TEST(workStealingDeque, owner) {
+    blet::WorkStealingDeque<int> deque(2);
+    int value = 0;
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop(value));
+    EXPECT_FALSE(deque.steal(value));
+    // grow past the initial capacity
+    for (int i = 0; i < 10; ++i) {
+        deque.push(i);
+    }
+    EXPECT_FALSE(deque.empty());
+    EXPECT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 0);
+    for (int i = 9; i > 0; --i) {
+        EXPECT_TRUE(deque.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(deque.empty());
+}
+
+static void stealAll(blet::WorkStealingDeque<int>* pDeque, long* pSum,
+                     int* pCount, int total) {
+    int value = 0;
+    while (__atomic_load_n(pCount, __ATOMIC_ACQUIRE) < total) {
+        if (pDeque->steal(value)) {
+            __atomic_fetch_add(pSum, value, __ATOMIC_RELAXED);
+            __atomic_fetch_add(pCount, 1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+GTEST_TEST(workStealingDeque, thieves) {
+    const int total = 100000;
+    blet::WorkStealingDeque<int> deque(16);
+    long sum = 0;
+    int count = 0;
+    blet::Thread thieves[3];
+    for (int i = 0; i < 3; ++i) {
+        thieves[i].start(&stealAll, &deque, &sum, &count, total);
+    }
+    long expected = 0;
+    int value = 0;
+    for (int i = 1; i <= total; ++i) {
+        deque.push(i);
+        expected += i;
+        if (i % 3 == 0 && deque.pop(value)) {
+            __atomic_fetch_add(&sum, static_cast<long>(value),
+                               __ATOMIC_RELAXED);
+            __atomic_fetch_add(&count, 1, __ATOMIC_RELEASE);
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        thieves[i].join();
+    }
+    // each value taken exactly once
+    EXPECT_EQ(count, total);
+    EXPECT_EQ(sum, expected);
+}
+
+GTEST_TEST(workStealingPool, size) {
+    blet::WorkStealingPool pool(3);
+    EXPECT_EQ(pool.size(), 3u);
+    blet::WorkStealingPool defaultPool;
+    EXPECT_GE(defaultPool.size(), 1u);
+}
+
+GTEST_TEST(workStealingPool, submit) {
+    MyTest t;
+    int value = 0;
+    MyTest::staticCount = 0;
+    blet::WorkStealingPool pool(4);
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit(&MyTest::staticMethodVoid);
+        pool.submit<int&>(&MyTest::staticMethodArg1, value);
+        pool.submit(&MyTest::methodArg2, &t, 1, 2);
+    }
+    pool.wait();
+    EXPECT_EQ(MyTest::staticCount, 1000);
+    EXPECT_EQ(value, 1000);
+    EXPECT_EQ(t.count, 3000);
+    blet::WorkStealingPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.localHits + stats.steals + stats.injected, 3000u);
+}
+
+GTEST_TEST(workStealingPool, fork) {
+    int leaves = 0;
+    blet::WorkStealingPool pool(4);
+    pool.submit(&forkTree, &pool, &leaves, 12);
+    pool.wait();
+    EXPECT_EQ(leaves, 1 << 12);
+    blet::WorkStealingPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.localHits + stats.steals + stats.injected,
+              (2ul << 12) - 1);
+    EXPECT_EQ(stats.injected, 1u);
+}
+
+GTEST_TEST(workStealingPool, destructorRunsPending) {
+    int leaves = 0;
+    {
+        blet::WorkStealingPool pool(1);
+        for (int i = 0; i < 8; ++i) {
+            pool.submit(&forkTree, &pool, &leaves, 6);
+        }
+    }
+    EXPECT_EQ(leaves, 8 << 6);
+}
+
+GTEST_TEST(workStealingPool, createException) {
+    MOCKC_NEW_INSTANCE(pthread_create);
+
+    EXPECT_CALL(MOCKC_INSTANCE(pthread_create), pthread_create(_, _, _, _))
+        .WillOnce(Invoke(mockc_real_func_pthread_create_singleton()))
+        .WillOnce(Return(-1));
+
+    EXPECT_THROW(
+        {
+            MOCKC_GUARD(pthread_create);
+            try {
+                blet::WorkStealingPool pool(2);
+            }
+            catch (const blet::Thread::Exception& e) {
+                EXPECT_STREQ(e.what(), "Failed to create thread");
+                throw;
+            }
+        },
+        blet::Thread::Exception);
+}
+
+static void throwRuntimeError(const char* a1) {
+    throw std::runtime_error(a1);
+}
+
+GTEST_TEST(workStealingPool, waitRethrows) {
+    MyTest::staticCount = 0;
+    blet::WorkStealingPool pool(2);
+    pool.submit(&throwRuntimeError, "boom");
+    pool.submit(&throwRuntimeError, "boom");
+    for (int i = 0; i < 100; ++i) {
+        pool.submit(&MyTest::staticMethodVoid);
+    }
+    EXPECT_THROW(
+        {
+            try {
+                pool.wait();
+            }
+            catch (const std::exception& e) {
+                EXPECT_STREQ(e.what(), "boom");
+                throw;
+            }
+        },
+        std::exception);
+    EXPECT_EQ(MyTest::staticCount, 100);
+    // the workers survive, the exception is only reported once
+    pool.submit(&MyTest::staticMethodVoid);
+    EXPECT_NO_THROW(pool.wait());
+    EXPECT_EQ(MyTest::staticCount, 101);
+    // never waited, dropped with the pool
+    pool.submit(&throwRuntimeError, "dropped");
+}